@@ -0,0 +1,66 @@
+#pragma once
+#include <cstddef>     // size_t
+#include <type_traits> // remove_const
+
+namespace pl {
+
+/// Alignment of a cache line on common hardware
+constexpr std::size_t cache_line_size = 64;
+
+// Policies that place every object at an Align boundary, taking a whole
+// number of Align-sized blocks, so objects never share a cache line.
+// Objects with a stronger alignment requirement get that alignment instead.
+// Objects must be made with pl::make, which allocates through the policy.
+
+/// Stores a pointer to a function that copies the object into aligned memory
+template <class Base, std::size_t Align = cache_line_size>
+class aligned_copy {
+	static_assert(Align != 0 && (Align & (Align - 1)) == 0,
+		"aligned_copy: Align must be a power of two");
+public:
+	constexpr aligned_copy() noexcept;
+
+	template <class Base2>
+	aligned_copy(const aligned_copy<Base2, Align>& other) noexcept;
+
+	template <class Derived>
+	aligned_copy(const Derived*);
+
+	Base* operator()(const Base* other);
+
+private:
+	typename std::remove_const<Base>::type* (*clone_ptr)(const Base*);
+
+	template <class Base2, std::size_t Align2>
+	friend class aligned_copy;
+};
+
+/// Destroys the object and frees its aligned memory
+template <class Base, std::size_t Align = cache_line_size>
+class aligned_delete {
+	static_assert(Align != 0 && (Align & (Align - 1)) == 0,
+		"aligned_delete: Align must be a power of two");
+public:
+	constexpr aligned_delete() noexcept = default;
+
+	template <class Base2>
+	aligned_delete(const aligned_delete<Base2, Align>&) noexcept;
+
+	/// Makes an object in aligned memory, used by pl::make
+	template <class Derived, class... Args>
+	static Derived* create(Args&&... args);
+
+	void operator()(const Base* ptr) const;
+};
+
+namespace detail {
+
+/// Allocates size bytes at an align boundary, rounded up to a multiple of
+/// align. Memory must be freed with aligned_free.
+void* aligned_allocate(std::size_t size, std::size_t align);
+void aligned_free(void* ptr) noexcept;
+
+} // namespace detail
+} // namespace pl
+
+#include "aligned_policies.inl"
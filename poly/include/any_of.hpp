@@ -0,0 +1,144 @@
+#pragma once
+#include <cstddef>     // size_t, max_align_t
+#include <typeinfo>    // type_info
+#include <type_traits> // decay, enable_if, is_nothrow_move_constructible
+#include "inheritance_traits.hpp"
+#include "method.hpp"
+#include "traits.hpp"
+
+namespace pl {
+
+/// Storage for any_of: objects that fit in Size bytes with alignment Align,
+/// and can be moved without exceptions, are stored inside the any_of.
+/// Other objects are allocated on the heap.
+template <std::size_t Size, std::size_t Align = alignof(std::max_align_t)>
+struct inline_storage {
+	static constexpr std::size_t size = Size;
+	static constexpr std::size_t align = Align;
+};
+
+/// Storage for any_of, that allocates every object on the heap
+using heap_storage = inline_storage<0, 1>;
+
+namespace detail {
+
+// any_slot and any_slots - the method part of a function table ================
+
+template <class Method>
+struct any_slot {
+	typename Method::thunk_type thunk;
+};
+
+template <class... Methods>
+struct any_slots : any_slot<Methods>... {
+	constexpr any_slots(typename Methods::thunk_type... thunks);
+};
+
+/// A function table for one type, stored in an any_of
+template <class... Methods>
+struct any_table {
+	constexpr any_table(const std::type_info& type,
+		void (*destroy)(void*),
+		void* (*copy)(const void*, void*),
+		void* (*move)(void*, void*),
+		typename Methods::thunk_type... thunks);
+
+	const std::type_info* type;
+	/// Destroys the object
+	void (*destroy)(void*);
+	/// Copies the object into the buffer or onto the heap, returns the copy
+	void* (*copy)(const void*, void*);
+	/// Moves the object into the buffer, or returns it if it's on the heap
+	void* (*move)(void*, void*);
+	any_slots<Methods...> methods;
+};
+
+/// Provides a function table for type T
+template <class Table, class T, bool Local>
+struct any_model;
+
+} // namespace detail
+
+/// Holds an object of any type, that implements methods of Interface,
+/// without requiring the type to derive from a base class.
+/// Interface is a type_list of methods. Every method call is one indirect
+/// call through a static function table of the held type.
+/// Held objects are copied using their copy constructor. Copying an object
+/// that is not copy-constructible throws std::runtime_error.
+template <class Interface, class Storage = inline_storage<3 * sizeof(void*)>>
+class any_of;
+
+template <class... Methods, std::size_t Size, std::size_t Align>
+class any_of<type_list<Methods...>, inline_storage<Size, Align>> {
+public:
+	using interface = type_list<Methods...>;
+	using storage = inline_storage<Size, Align>;
+
+	/// Checks if objects of type T are stored inside the any_of
+	template <class T>
+	struct is_local : std::integral_constant<bool,
+		sizeof(T) <= Size &&
+		Align % alignof(T) == 0 &&
+		std::is_nothrow_move_constructible<T>::value> {
+	};
+
+	// Construction ============================================================
+	any_of() noexcept;
+	any_of(const any_of& other);
+	any_of(any_of&& other) noexcept;
+	any_of& operator=(const any_of& other);
+	any_of& operator=(any_of&& other) noexcept;
+
+	template <class T, class = typename std::enable_if<
+		!std::is_same<typename std::decay<T>::type, any_of>::value>::type>
+	any_of(T&& value);
+
+	~any_of();
+
+	// Observers ===============================================================
+	template <class T>
+	bool is() const noexcept;
+
+	/// Returns typeid of the held object, or typeid(void) if empty
+	const std::type_info& type() const noexcept;
+
+	explicit operator bool() const noexcept;
+
+	// Modifiers ===============================================================
+	template <class T, class... Args>
+	T& emplace(Args&&... args);
+
+	void reset() noexcept;
+
+	// Member access ===========================================================
+	template <class T>
+	T* as() noexcept;
+	template <class T>
+	const T* as() const noexcept;
+
+	/// Calls a method on the held object. any_of must not be empty.
+	template <class Method, class... Args>
+	typename Method::result_type call(Args&&... args);
+	template <class Method, class... Args>
+	typename Method::result_type call(Args&&... args) const;
+
+private:
+	using table = detail::any_table<Methods...>;
+
+	template <class T>
+	using model = detail::any_model<table, T, is_local<T>::value>;
+
+	/// Makes an object in the buffer (true_type) or on the heap (false_type)
+	template <class T, class... Args>
+	void* create(std::true_type, Args&&... args);
+	template <class T, class... Args>
+	void* create(std::false_type, Args&&... args);
+
+	const table* vtable;
+	void* object;
+	alignas(Align) unsigned char buffer[Size == 0 ? 1 : Size];
+};
+
+} // namespace pl
+
+#include "any_of.inl"
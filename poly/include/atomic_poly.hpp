@@ -0,0 +1,72 @@
+#pragma once
+#include <atomic> // atomic
+#include "poly.hpp"
+#include "epoch.hpp"
+
+namespace pl {
+
+/// Holds a poly that can be read and replaced concurrently.
+/// Readers get a read_handle, that keeps the object alive until the handle
+/// is destroyed. Taking a handle is wait-free. Replaced objects are
+/// destroyed through the policy's destroy, once no handle can refer to them.
+template <class Base, class CopyDeletePolicy = deep<Base>>
+class atomic_poly {
+public:
+	using base_type = Base;
+	using policy = CopyDeletePolicy;
+	using poly_type = poly<Base, CopyDeletePolicy>;
+
+	/// Guarded access to the object, held by atomic_poly at the time of load.
+	/// Handles should be short-lived: while any handle exists, no replaced
+	/// object is destroyed. A handle must be destroyed on the thread that
+	/// loaded it.
+	class read_handle {
+	public:
+		Base& operator*() const;
+		Base* operator->() const noexcept;
+		Base* get() const noexcept;
+
+		explicit operator bool() const noexcept;
+
+	private:
+		explicit read_handle(const poly_type* node) noexcept;
+
+		detail::epoch_domain::guard guard;
+		const poly_type* node;
+
+		friend class atomic_poly;
+	};
+
+	// Construction ============================================================
+	atomic_poly() noexcept;
+	explicit atomic_poly(poly_type value);
+	atomic_poly(const atomic_poly&) = delete;
+	atomic_poly& operator=(const atomic_poly&) = delete;
+
+	/// Destroys the held object immediately. No handles may exist.
+	~atomic_poly();
+
+	// Operations ==============================================================
+	read_handle load() const;
+
+	/// Replaces the object. The old object is destroyed later.
+	void store(poly_type value);
+
+	/// Replaces the object and returns the old one. Blocks until no handle
+	/// can refer to the old object, so it must not be called while the
+	/// calling thread holds a handle.
+	poly_type exchange(poly_type value);
+
+	/// Replaces the object with desired, if the held object is the one that
+	/// expected refers to. Otherwise, desired is left untouched.
+	bool compare_exchange(const read_handle& expected, poly_type& desired);
+
+private:
+	static void destroy_node(void* node);
+
+	std::atomic<poly_type*> data;
+};
+
+} // namespace pl
+
+#include "atomic_poly.inl"
@@ -0,0 +1,10 @@
+#pragma once
+#include <string>
+
+class Benchmarker {
+private:
+	static void print_benchmark_result(const std::string& name, double value, const std::string& unit);
+
+public:
+	void run();
+};
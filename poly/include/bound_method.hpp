@@ -0,0 +1,46 @@
+#pragma once
+#include "method.hpp"
+#include "poly.hpp"
+#include "traits.hpp"
+
+namespace pl {
+
+/// A method, bound to an object of a known exact type.
+/// Calling it is one indirect call to a function, where Method::call is
+/// instantiated with the exact type of the object, so it can call the method
+/// without virtual dispatch (e.g. obj.T::name()).
+/// Like an iterator, a bound_method is invalidated when the poly it was made
+/// from is reset, assigned or destroyed.
+template <class Method>
+class bound_method {
+public:
+	using method_type = Method;
+	using result_type = typename Method::result_type;
+
+	constexpr bound_method() noexcept;
+
+	/// Calls the method. bound_method must not be empty or invalidated.
+	template <class... Args>
+	result_type operator()(Args&&... args) const;
+
+	explicit constexpr operator bool() const noexcept;
+
+	template <class Method2, class List, class Base, class CopyDeletePolicy>
+	friend bound_method<Method2> bound(const poly<Base, CopyDeletePolicy>& p);
+
+private:
+	bound_method(void* object, typename Method::thunk_type thunk) noexcept;
+
+	void* object;
+	typename Method::thunk_type thunk;
+};
+
+/// Binds Method to the object of p. The exact type of the object must be
+/// one of the types in List. Throws std::invalid_argument if p is empty, or
+/// if its object is not of a type in List.
+template <class Method, class List, class Base, class CopyDeletePolicy>
+bound_method<Method> bound(const poly<Base, CopyDeletePolicy>& p);
+
+} // namespace pl
+
+#include "bound_method.inl"
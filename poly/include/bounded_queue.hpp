@@ -0,0 +1,101 @@
+#pragma once
+#include <atomic>  // atomic
+#include <cstddef> // size_t
+#include <memory>  // unique_ptr
+
+namespace pl {
+namespace detail {
+
+/// Bounded lock-free multi-producer multi-consumer queue.
+/// Each cell holds a sequence number that tells producers and consumers
+/// whether the cell is free for the current lap around the ring.
+/// A consumer locks the first cell before it moves the value out, so other
+/// consumers see the queue as empty until it's done. Batches claim their
+/// cells with one atomic operation.
+/// T must be default-constructible and nothrow move-assignable.
+template <class T>
+class bounded_queue {
+public:
+	/// Capacity is rounded up to a power of two
+	explicit bounded_queue(std::size_t capacity);
+
+	bounded_queue(const bounded_queue&) = delete;
+	bounded_queue& operator=(const bounded_queue&) = delete;
+
+	/// Returns false if the queue is full, value is left untouched
+	bool try_push(T& value) noexcept;
+	/// Returns false if the queue is empty
+	bool try_pop(T& value) noexcept;
+
+	/// Pushes values from [first, last) until the queue is full. Returns the
+	/// iterator past the last pushed value. It is a forward iterator.
+	template <class It>
+	It try_push(It first, It last) noexcept;
+	/// Pops up to max values to out, returns how many were popped. If out
+	/// throws, values that were not moved out yet stay in the queue.
+	template <class OutputIt>
+	std::size_t try_pop(OutputIt out, std::size_t max);
+
+	std::size_t capacity() const noexcept;
+
+private:
+	/// Locks the cell at dequeue_pos, and returns its position in pos.
+	/// Returns false if the queue is empty, or another consumer holds the lock.
+	bool lock_front(std::size_t& pos) noexcept;
+	/// Pops n values from pos, that were moved out, and unlocks the queue
+	void pop_front(std::size_t pos, std::size_t n) noexcept;
+
+	struct cell {
+		std::atomic<std::size_t> sequence;
+		T value;
+	};
+
+	std::unique_ptr<cell[]> cells;
+	std::size_t mask;
+
+	// Producers and consumers touch different cache lines
+	alignas(64) std::atomic<std::size_t> enqueue_pos;
+	alignas(64) std::atomic<std::size_t> dequeue_pos;
+};
+
+/// Bounded lock-free single-producer single-consumer queue.
+/// The producer and the consumer each keep a copy of the other's position,
+/// and only reload it when the queue looks full or empty. Batches are
+/// published with one store.
+/// T must be default-constructible and nothrow move-assignable.
+template <class T>
+class spsc_queue {
+public:
+	/// Capacity is rounded up to a power of two
+	explicit spsc_queue(std::size_t capacity);
+
+	spsc_queue(const spsc_queue&) = delete;
+	spsc_queue& operator=(const spsc_queue&) = delete;
+
+	bool try_push(T& value) noexcept;
+	bool try_pop(T& value) noexcept;
+
+	template <class It>
+	It try_push(It first, It last) noexcept;
+	template <class OutputIt>
+	std::size_t try_pop(OutputIt out, std::size_t max);
+
+	std::size_t capacity() const noexcept;
+
+private:
+	std::unique_ptr<T[]> cells;
+	std::size_t mask;
+
+	// Written by the consumer
+	alignas(64) std::atomic<std::size_t> head;
+	std::size_t cached_tail;
+
+	// Written by the producer
+	alignas(64) std::atomic<std::size_t> tail;
+	std::size_t cached_head;
+};
+
+} // namespace detail
+} // namespace pl
+
+#include "bounded_queue.inl"
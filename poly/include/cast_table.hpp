@@ -0,0 +1,35 @@
+#pragma once
+#include <cstddef>     // ptrdiff_t
+#include <cstdint>     // PTRDIFF_MIN
+#include <typeinfo>    // type_info
+#include "snapshot_map.hpp"
+
+namespace pl {
+namespace detail {
+
+/// Converts Base* to Target*, where Target is any base of the object's
+/// dynamic type: a base of Base, a class derived from Base, or a sibling.
+/// For a given dynamic type, the offset between its Base and Target
+/// subobjects is constant, even with virtual bases. The offset is found
+/// with one dynamic_cast on the first conversion of every dynamic type,
+/// and then looked up by the address of its type_info.
+template <class Base, class Target>
+class cast_table {
+public:
+	/// Returns nullptr if ptr is null, or if Target is not an unambiguous
+	/// public base of ptr's dynamic type.
+	static Target* cast(Base* ptr);
+	static const Target* cast(const Base* ptr);
+
+private:
+	/// Marks dynamic types that can't be converted to Target
+	static constexpr std::ptrdiff_t none = PTRDIFF_MIN;
+
+	static snapshot_map<const std::type_info*, std::ptrdiff_t>& offsets();
+	static std::ptrdiff_t offset(const Base* ptr);
+};
+
+} // namespace detail
+} // namespace pl
+
+#include "cast_table.inl"
@@ -0,0 +1,172 @@
+#pragma once
+#include <chrono>      // nanoseconds
+#include <cstddef>     // size_t, max_align_t
+#include <memory>      // unique_ptr
+#include <mutex>       // mutex
+#include <type_traits> // remove_const
+#include <vector>      // vector
+
+namespace pl {
+namespace detail {
+
+/// Operations on objects of one type, stored in a compacting_arena
+struct arena_type {
+	std::size_t size;
+	void (*destroy)(void* obj);
+	/// Move-constructs the object at to, and destroys the original
+	void (*relocate)(void* from, void* to);
+	/// Copy-constructs the object at to. Throws if the type is not copyable.
+	void (*copy)(const void* from, void* to);
+};
+
+/// Provides an arena_type for type T
+template <class T>
+struct arena_model {
+	static const arena_type value;
+};
+
+} // namespace detail
+
+/// An arena for objects of classes, derived from Base, that are owned by
+/// polys with the compacting policy. Objects are placed one after another
+/// in large blocks. Every object is preceded by a header with the functions
+/// of its type, recorded when it's made, and the address of the pointer in
+/// the poly that owns it.
+/// compact() moves objects out of blocks that are mostly empty, updates
+/// the polys that own them, and frees the emptied blocks.
+/// Objects are made and destroyed under a lock, but compact() must not run
+/// while other threads use objects of the arena. Pointers and references to
+/// objects, other than the owning polys, are invalidated by compact().
+template <class Base>
+class compacting_arena {
+public:
+	/// Objects with a stronger alignment requirement can't be stored
+	static constexpr std::size_t max_align = alignof(std::max_align_t);
+
+	/// Blocks are block_size bytes long, or as long as one object, if it's
+	/// larger. Blocks, less than threshold full, are compacted.
+	explicit compacting_arena(std::size_t block_size = 256 * 1024, double threshold = 0.5);
+	compacting_arena(const compacting_arena&) = delete;
+	compacting_arena& operator=(const compacting_arena&) = delete;
+
+	/// All objects must be destroyed before the arena
+	~compacting_arena();
+
+	// Compaction ==============================================================
+
+	/// Moves objects out of sparse blocks, sparsest first, until budget runs
+	/// out. Returns true if there is nothing left to compact.
+	/// Move constructors of the objects must not make or destroy objects in
+	/// the same arena.
+	bool compact(std::chrono::nanoseconds budget = std::chrono::nanoseconds::max());
+
+	// Statistics ==============================================================
+	std::size_t block_count() const;
+	/// Bytes in all blocks
+	std::size_t capacity() const;
+	/// Bytes, used by live objects and their headers
+	std::size_t live() const;
+
+	// Objects =================================================================
+	// Used by the compacting policy.
+
+	template <class T, class... Args>
+	T* create(Args&&... args);
+	/// Copies the object of obj into the arena, returns the copy's Base
+	Base* copy(const Base* obj);
+	void destroy(const Base* obj) noexcept;
+
+	/// Records, that the poly keeps the pointer to its object in data
+	template <class B>
+	static void adopt(B*& data) noexcept;
+	/// Records, that no poly owns the object, so it's never moved
+	static void forget(const Base* obj) noexcept;
+
+private:
+	struct block {
+		unsigned char* memory;
+		std::size_t size;  // Bytes in the block
+		std::size_t top;   // Bytes, taken by live and dead objects
+		std::size_t live;  // Bytes, taken by live objects
+		std::size_t index; // Position in blocks
+	};
+
+	struct alignas(std::max_align_t) header {
+		const detail::arena_type* type; // nullptr if there is no object
+		Base** owner;                   // nullptr if no poly owns the object
+		block* home;
+		std::size_t size;               // Bytes, including the header
+	};
+
+	/// Bytes, taken by an object of type T and its header
+	template <class T>
+	static std::size_t footprint() noexcept;
+
+	static header* header_of(const Base* obj) noexcept;
+	static unsigned char* object_of(header* h) noexcept;
+
+	/// Checks if h holds an object, owned by a poly, which can be moved
+	static bool is_movable(header* h) noexcept;
+
+	// These functions must be called under the lock
+	header* allocate(std::size_t size);
+	void release(header* h) noexcept;
+	void free_block(block* b) noexcept;
+
+	std::size_t block_size;
+	double threshold;
+
+	mutable std::mutex mutex;
+	std::vector<std::unique_ptr<block>> blocks;
+	block* current; // Block, where new objects are placed
+	std::size_t capacity_bytes;
+	std::size_t live_bytes;
+};
+
+/// Arena, used by the compacting policy. Constructed on first use, and never
+/// destroyed, so that polys with static storage duration can outlive it.
+template <class Base>
+compacting_arena<Base>& default_arena();
+
+// Policies that place objects in default_arena(), so that they can be
+// compacted. Objects must be made with pl::make, which allocates through
+// the policy, and their alignment must not exceed max_align.
+
+/// Copies the object into the arena
+template <class Base>
+class arena_copy {
+public:
+	constexpr arena_copy() noexcept = default;
+
+	template <class Base2>
+	arena_copy(const arena_copy<Base2>&) noexcept;
+
+	Base* operator()(const Base* other) const;
+};
+
+/// Destroys the object in the arena, and tells the arena, which poly owns it
+template <class Base>
+class arena_delete {
+public:
+	using arena_type = compacting_arena<typename std::remove_const<Base>::type>;
+
+	constexpr arena_delete() noexcept = default;
+
+	template <class Base2>
+	arena_delete(const arena_delete<Base2>&) noexcept;
+
+	/// Makes an object in the arena, used by pl::make
+	template <class Derived, class... Args>
+	static Derived* create(Args&&... args);
+
+	void operator()(const Base* ptr) const;
+
+	/// Called by poly, when it takes ownership of an object or moves
+	void adopt(Base*& data) const noexcept;
+	/// Called by poly, when it releases an object
+	void forget(const Base* data) const noexcept;
+};
+
+} // namespace pl
+
+#include "compacting_arena.inl"
@@ -1,5 +1,6 @@
 #pragma once
 #include <type_traits> // is_constructible
+#include <utility>     // declval, forward
 
 // MSVC fails to optimize using EBO by default.
 // This macro enables the optimization
@@ -36,6 +37,26 @@ public:
 	template <class T>
 	void destroy(T* ptr);
 
+	// Allocation --------------------------------------------------------------
+	// If Deleter defines a static create<T>(args...), pl::make uses it to make
+	// objects, so that Deleter can free them.
+	// D is a copy of Deleter, so that the return type is checked lazily.
+	template <class T, class D = Deleter, class... Args>
+	static auto create(Args&&... args)
+		-> decltype(D::template create<T>(std::forward<Args>(args)...));
+
+	// Tracking ----------------------------------------------------------------
+	// If Deleter defines adopt(data) and forget(data), poly calls them to tell
+	// where it keeps the pointer to its object, and when it lets the object
+	// go, so that Deleter can move objects and update their polys.
+	template <class T, class D = Deleter>
+	auto adopt(T*& data) noexcept
+		-> decltype(std::declval<const D&>().adopt(data));
+
+	template <class T, class D = Deleter>
+	auto forget(const T* data) noexcept
+		-> decltype(std::declval<const D&>().forget(data));
+
 	// Friends =================================================================
 	template <class Cloner2, class Deleter2>
 	friend class compound;
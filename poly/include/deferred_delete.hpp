@@ -0,0 +1,79 @@
+#pragma once
+#include <atomic>             // atomic
+#include <chrono>             // milliseconds
+#include <condition_variable> // condition_variable
+#include <cstddef>            // size_t
+#include <mutex>              // mutex
+#include <thread>             // thread
+#include "bounded_queue.hpp"
+
+namespace pl {
+
+/// Destroys retired objects later: on drain(), or on a background thread.
+/// Retired objects are kept in a bounded lock-free queue. When the queue
+/// is full, the retiring thread destroys the object itself, so memory held
+/// by retired objects never grows past capacity.
+class reclaimer {
+public:
+	explicit reclaimer(std::size_t capacity = 65536);
+	reclaimer(const reclaimer&) = delete;
+	reclaimer& operator=(const reclaimer&) = delete;
+
+	/// Stops the background thread and destroys all retired objects
+	~reclaimer();
+
+	/// Queues ptr to be destroyed by destroy(ptr)
+	void retire(void* ptr, void (*destroy)(void*)) noexcept;
+
+	/// Destroys up to max retired objects, returns how many were destroyed
+	std::size_t drain(std::size_t max = static_cast<std::size_t>(-1)) noexcept;
+
+	/// Starts a thread that drains the queue, checking it every interval
+	/// while it's empty. Does nothing if the thread is running.
+	void start(std::chrono::milliseconds interval = std::chrono::milliseconds(1));
+	void stop();
+
+	/// How many objects were destroyed on retire because the queue was full
+	std::size_t overflows() const noexcept;
+
+private:
+	struct retired {
+		void* ptr;
+		void (*destroy)(void*);
+	};
+
+	void work(std::chrono::milliseconds interval);
+
+	detail::bounded_queue<retired> queue;
+	std::atomic<std::size_t> overflow_count;
+
+	std::mutex thread_mutex;
+	std::condition_variable wake;
+	std::thread thread;
+	bool running;
+};
+
+/// Reclaimer, used by deferred_delete. Constructed on first use.
+reclaimer& default_reclaimer();
+
+/// Destroys all objects, retired to the default reclaimer so far
+std::size_t drain();
+
+/// Deleter that retires objects to default_reclaimer() instead of deleting
+/// them in place. Requires a virtual destructor, same as default_delete.
+/// Objects retired after the default reclaimer is destroyed are deleted
+/// in place.
+template <class Base>
+class deferred_delete {
+public:
+	constexpr deferred_delete() noexcept = default;
+
+	template <class Base2>
+	deferred_delete(const deferred_delete<Base2>& other) noexcept;
+
+	void operator()(const Base* ptr) const;
+};
+
+} // namespace pl
+
+#include "deferred_delete.inl"
@@ -33,6 +33,19 @@ private:
 	friend class pmr_delete;
 };
 
+/// Calls the destructor, but does not free memory. Used for objects, made in
+/// memory that is owned by someone else.
+template <class Base>
+class in_place_delete {
+public:
+	constexpr in_place_delete() noexcept = default;
+
+	template <class Base2>
+	in_place_delete(const in_place_delete<Base2>&) noexcept;
+
+	void operator()(const Base* ptr) const;
+};
+
 } // namespace pl
 
 #include "delete_policies.inl"
\ No newline at end of file
@@ -0,0 +1,86 @@
+#pragma once
+#include <array>         // array
+#include <cstddef>       // size_t
+#include <stdexcept>     // invalid_argument
+#include <typeindex>     // type_index
+#include <type_traits>   // conditional, is_const
+#include <unordered_map> // unordered_map
+#include "poly.hpp"
+
+namespace pl {
+namespace detail {
+
+/// Result of dispatching to Handlers: Handlers::result_type, or void
+template <class Handlers, class Enable = void>
+struct dispatch_result {
+	using type = void;
+};
+
+template <class Handlers>
+struct dispatch_result<Handlers,
+	typename enable_if_defined<typename Handlers::result_type>::type> {
+	using type = typename Handlers::result_type;
+};
+
+/// Default fallback of dispatch. Throws std::invalid_argument.
+template <class R>
+struct dispatch_throw {
+	template <class Base1, class Base2>
+	R operator()(Base1& x, Base2& y) const;
+};
+
+/// Maps a dynamic type to its position in a type_list in O(1).
+/// Returns List::size if the type is not in the list.
+template <class List>
+struct type_indices;
+
+template <class... Ts>
+struct type_indices<type_list<Ts...>> {
+	template <class Base>
+	static std::size_t of(const Base& obj);
+};
+
+/// A table of N x M functions, one for every pair of types in List1 x List2.
+/// Each function downcasts both arguments and calls the handler for them.
+template <class R, class Base1, class Base2, class Handlers, class Fallback,
+	bool Symmetric, class List1, class List2>
+struct dispatch_table;
+
+} // namespace detail
+
+// Dispatch ====================================================================
+// Calls handlers(d1, d2), where d1 and d2 are the objects, stored in x and y,
+// downcast to their exact types. Types must be listed in List1 and List2.
+// If the types are not listed, or handlers can't be called with them,
+// fallback(*x, *y) is called instead. The default fallback throws.
+// Returns Handlers::result_type if it's defined, and void otherwise.
+
+template <class List1, class List2,
+	class B1, class P1, class B2, class P2, class Handlers>
+typename detail::dispatch_result<typename std::decay<Handlers>::type>::type
+dispatch(const poly<B1, P1>& x, const poly<B2, P2>& y, Handlers&& handlers);
+
+template <class List1, class List2,
+	class B1, class P1, class B2, class P2, class Handlers, class Fallback>
+typename detail::dispatch_result<typename std::decay<Handlers>::type>::type
+dispatch(const poly<B1, P1>& x, const poly<B2, P2>& y, Handlers&& handlers,
+	Fallback&& fallback);
+
+// Symmetric dispatch ==========================================================
+// Same as dispatch, but if handlers(d1, d2) can't be called, handlers(d2, d1)
+// is called instead. That way, every unordered pair is handled once.
+
+template <class List, class B1, class P1, class B2, class P2, class Handlers>
+typename detail::dispatch_result<typename std::decay<Handlers>::type>::type
+symmetric_dispatch(const poly<B1, P1>& x, const poly<B2, P2>& y,
+	Handlers&& handlers);
+
+template <class List,
+	class B1, class P1, class B2, class P2, class Handlers, class Fallback>
+typename detail::dispatch_result<typename std::decay<Handlers>::type>::type
+symmetric_dispatch(const poly<B1, P1>& x, const poly<B2, P2>& y,
+	Handlers&& handlers, Fallback&& fallback);
+
+} // namespace pl
+
+#include "dispatch.inl"
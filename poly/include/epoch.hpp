@@ -0,0 +1,79 @@
+#pragma once
+#include <atomic>  // atomic
+#include <cstdint> // uint64_t
+#include <mutex>   // mutex
+#include <vector>  // vector
+
+namespace pl {
+namespace detail {
+
+/// Epoch-based reclamation. Readers enter a critical section by publishing
+/// the current global epoch, which is wait-free after a thread's first use.
+/// Writers retire objects with the epoch at the time of retirement. The
+/// global epoch only advances when every active reader has seen it, so an
+/// object is freed once the epoch has advanced twice past its retirement.
+class epoch_domain {
+public:
+	/// Per-thread state. Records are never freed, and are reused by new
+	/// threads after their owner thread exits.
+	struct record {
+		std::atomic<std::uint64_t> epoch; // 0 if not in a critical section
+		std::atomic<bool> in_use;
+		record* next;
+		unsigned nesting;                 // Only accessed by the owner
+	};
+
+	/// RAII critical section. Objects, retired after the guard is created,
+	/// are not freed until it's destroyed. A guard must be destroyed on the
+	/// thread that created it.
+	class guard {
+	public:
+		guard() noexcept;
+		guard(guard&& other) noexcept;
+		guard(const guard&) = delete;
+		guard& operator=(const guard&) = delete;
+		~guard();
+
+	private:
+		record* rec;
+	};
+
+	/// Domain shared by all users. Never destroyed, so that guards and
+	/// retirements remain valid during static destruction.
+	static epoch_domain& instance();
+
+	/// Schedules destroy(ptr) for when no reader can hold ptr anymore
+	void retire(void* ptr, void (*destroy)(void*));
+
+	/// Blocks until every critical section, entered before the call, exits.
+	/// Must not be called inside a critical section.
+	void synchronize();
+
+	/// Frees retired objects that no reader can hold
+	void collect();
+
+private:
+	struct retired {
+		std::uint64_t epoch;
+		void* ptr;
+		void (*destroy)(void*);
+	};
+
+	epoch_domain() noexcept;
+
+	/// Record of the calling thread, acquired on first use
+	record* local();
+	record* acquire();
+	bool try_advance();
+
+	std::atomic<std::uint64_t> global_epoch;
+	std::atomic<record*> records;
+
+	std::mutex retired_mutex;
+	std::vector<retired> retired_list;
+};
+
+} // namespace detail
+} // namespace pl
+
+#include "epoch.inl"
@@ -1,25 +1,140 @@
 #pragma once
 
+#include <array>         // array
+#include <cstddef>       // size_t
+#include <utility>       // pair
 #include <vector>        // vector
 #include <string>        // string
+#include <typeinfo>      // type_info
 #include <type_traits>   // is_base_of, is_default_constructible
 #include "poly.hpp"
+#include "type_layout.hpp"
 
 namespace pl {
 
 template <class Base, class CopyDeletePolicy = deep<Base>>
 class factory {
 public:
+	/// Dense integer id of a registered type. Ids are assigned in order of
+	/// registration and never change, even when more types are inserted.
+	using handle = std::size_t;
+
 	template <class Derived>
-	void insert();
-	
+	handle insert();
+
+	// Bulk insertion ----------------------------------------------------------
+	// Sorts the inserted names once and merges them into the index, instead of
+	// inserting them one by one, which moves the index on every insert. The
+	// result is the same as inserting the types one by one, in order.
+
+	/// A type to insert with bulk_insert
+	class registration;
+
+	/// Inserts types, as insert<Derived>() does, returns their handles
+	template <class... Derived>
+	std::array<handle, sizeof...(Derived)> insert_all();
+	/// Inserts registrations from [first, last), and writes their handles to
+	/// out. Registrations are copied, use std::make_move_iterator to move them.
+	template <class InputIt, class OutputIt>
+	OutputIt bulk_insert(InputIt first, InputIt last, OutputIt out);
+	template <class InputIt>
+	void bulk_insert(InputIt first, InputIt last);
+
+	// Prototypes --------------------------------------------------------------
+	// make() copies a registered prototype instead of default-constructing.
+	// Replaces a type, registered under the same name.
+	template <class Derived, class... Args>
+	handle insert_prototype(Args&&... args);
+	handle insert_prototype(std::string name, poly<Base, CopyDeletePolicy> prototype);
+
 	std::vector<std::string> list() const;
+	bool contains(const std::string& name) const;
+	/// Returns the type, made by make(name), or nullptr if none is registered
+	const std::type_info* type_of(const std::string& name) const;
 	poly<Base, CopyDeletePolicy> make(const std::string& name) const;
 
+	// Handles -----------------------------------------------------------------
+	handle id_of(const std::string& name) const;
+	/// Resolves every name in [first, last) and writes its handle to out
+	template <class InputIt, class OutputIt>
+	OutputIt id_of(InputIt first, InputIt last, OutputIt out) const;
+
+	/// Makes a poly by handle. Throws std::out_of_range for invalid handles.
+	poly<Base, CopyDeletePolicy> make(handle id) const;
+
+	// Layout ------------------------------------------------------------------
+	// Layouts are known for types, inserted by type (insert<Derived>() and
+	// insert_prototype<Derived>(args...)), but not for prototypes inserted
+	// as a poly.
+
+	/// Returns the layout of a type, or nullptr if it's not known
+	const type_layout<Base>* layout_of(const std::string& name) const;
+	/// Throw std::invalid_argument if the layout is not known
+	std::size_t size_of(const std::string& name) const;
+	std::size_t align_of(const std::string& name) const;
+	/// Largest size and alignment of all types with a known layout
+	std::size_t max_size() const noexcept;
+	std::size_t max_align() const noexcept;
+
+	/// Makes an object in memory, that must have at least size_of(name) bytes
+	/// at an align_of(name) boundary. The returned poly destroys the object,
+	/// but doesn't free the memory. Throws std::invalid_argument if the layout
+	/// is not known.
+	poly<Base, in_place<Base>> construct_at(const std::string& name, void* memory) const;
+	poly<Base, in_place<Base>> construct_at(handle id, void* memory) const;
+
+private:
+	using poly_type = poly<Base, CopyDeletePolicy>;
+
+	struct entry {
+		const std::type_info* type;
+		poly_type (*make)(const poly_type& prototype);
+		poly_type prototype;
+		const type_layout<Base>* layout; // nullptr if not known
+	};
+
+	using name_index = std::vector<std::pair<std::string, handle>>;
+
+	/// Returns the position of name in names, or names.cend()
+	typename name_index::const_iterator find(const std::string& name) const;
+	handle insert_entry(std::string name, entry e, bool replace);
+	/// Inserts n registrations, writes their handles to ids
+	void insert_batch(registration* batch, std::size_t n, handle* ids);
+	handle insert_prototype(std::string name, poly_type prototype,
+		const type_layout<Base>* layout);
+	/// Returns the entry of a handle, throws std::out_of_range if invalid
+	const entry& entry_of(handle id) const;
+	/// Returns the layout of an entry, throws std::invalid_argument if unknown
+	static const type_layout<Base>& known_layout(const entry& e);
+
+	static poly_type copy_prototype(const poly_type& prototype);
+
+	template <class Derived>
+	static poly_type make_default(const poly_type& prototype);
+
+	std::vector<entry> make_funcs; // Indexed by handle
+	name_index names;              // Sorted by name
+};
+
+template <class Base, class CopyDeletePolicy>
+class factory<Base, CopyDeletePolicy>::registration {
+public:
+	/// Registers Derived, as insert<Derived>() does
+	template <class Derived>
+	static registration of();
+	/// Registers a prototype, as insert_prototype(name, prototype) does
+	registration(std::string name, poly<Base, CopyDeletePolicy> prototype);
+
 private:
-	std::vector<std::pair<std::string, poly<Base, CopyDeletePolicy>(*)()>> make_funcs;
+	friend class factory;
+
+	registration(std::string name, entry e, bool replace);
+
+	std::string name;
+	entry e;
+	bool replace; // Replaces a type, registered under the same name
 };
 
 } // namespace pl
 
-#include "factory.inl"
\ No newline at end of file
+#include "factory.inl"
@@ -1,6 +1,7 @@
 #pragma once
 #include <atomic>      // atomic
 #include <cstddef>     // ptrdiff_t
+#include <cstdint>     // PTRDIFF_MIN
 #include <type_traits> // is_base_of, remove_cv
 
 /*!
@@ -35,6 +36,13 @@ public:
 	static const Derived* downcast(const Base* ptr);
 
 private:
+	/// Marks an offset that was not set yet
+	static constexpr std::ptrdiff_t unknown = PTRDIFF_MIN;
+
+	/// Returns the offset, finding it with dynamic_cast if it was not set,
+	/// which happens when Derived was never adopted by a poly<Base>
+	static std::ptrdiff_t get_offset(const Base* ptr);
+
 	/// Holds a memory offset that converts Base* to Derived*
 	static std::atomic<std::ptrdiff_t> offset;
 };
@@ -0,0 +1,60 @@
+#pragma once
+#include <cstddef>     // size_t
+#include <typeinfo>    // type_info
+#include <type_traits> // decay
+#include <vector>      // vector
+#include "dispatch.hpp"
+#include "poly.hpp"
+
+namespace pl {
+
+/// A cache of the dynamic types, seen at one call site.
+/// Calls handler(d), where d is the object of a poly, downcast to its exact
+/// type, if that type is in List. Otherwise calls handler(b), where b is the
+/// object as Base&, so that a virtual call can be made instead.
+/// The K types that were seen most often are kept in the cache, and are
+/// found by comparing type_info addresses. Other types are looked up on
+/// every call, and counted, so that a type that becomes more common replaces
+/// the least common type in the cache.
+/// Returns Handler::result_type if it's defined, and void otherwise.
+/// An inline_cache is not thread-safe, use one per thread.
+template <class Base, std::size_t K, class List>
+class inline_cache {
+	static_assert(K > 0, "inline_cache: K must be positive");
+public:
+	inline_cache() noexcept;
+
+	/// Throws std::invalid_argument if p is empty
+	template <class CopyDeletePolicy, class Handler>
+	typename detail::dispatch_result<typename std::decay<Handler>::type>::type
+	operator()(const poly<Base, CopyDeletePolicy>& p, Handler&& handler);
+
+	// Counters ================================================================
+	std::size_t hits() const noexcept;
+	std::size_t misses() const noexcept;
+	/// Share of calls that were hits, or 0 if there were no calls
+	double hit_rate() const noexcept;
+	void reset_counters() noexcept;
+
+private:
+	struct entry {
+		const std::type_info* type;
+		std::size_t index; // Position in List, or List::size for other types
+		std::size_t count; // Calls since the last decay
+	};
+
+	/// Looks up a type, that is not in the cache, and returns its index
+	std::size_t miss(const Base& obj);
+
+	/// Halves all counts every this many misses, so that old calls matter less
+	static constexpr std::size_t decay_period = 1024;
+
+	entry entries[K];
+	std::vector<entry> candidates; // Types, seen on misses
+	std::size_t hit_count;
+	std::size_t miss_count;
+};
+
+} // namespace pl
+
+#include "inline_cache.inl"
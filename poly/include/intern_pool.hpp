@@ -0,0 +1,79 @@
+#pragma once
+#include <cstddef>       // size_t
+#include <functional>    // hash, equal_to
+#include <memory>        // shared_ptr, weak_ptr
+#include <mutex>         // mutex
+#include <unordered_map> // unordered_multimap
+#include <vector>        // vector
+#include "poly.hpp"
+
+namespace pl {
+
+/// Deduplicates immutable polymorphic objects. intern() returns a shared
+/// handle to the canonical object, equal to the given one. Objects are equal
+/// if they are of the same dynamic type, and Equal returns true for them.
+/// Hash and Equal are called with const Base&, and Equal is only called for
+/// objects of the same dynamic type.
+/// The pool is split into shards with a mutex each, so threads interning
+/// different objects rarely wait for each other. A canonical object is
+/// destroyed when its last handle is destroyed, and handles may outlive
+/// the pool.
+template <class Base,
+	class Hash = std::hash<Base>,
+	class Equal = std::equal_to<Base>,
+	class CopyDeletePolicy = deep<const Base>>
+class intern_pool {
+public:
+	using base_type = Base;
+	using poly_type = poly<const Base, CopyDeletePolicy>;
+	using handle = std::shared_ptr<const Base>;
+
+	explicit intern_pool(std::size_t shard_count = 16,
+		const Hash& hash = Hash(), const Equal& equal = Equal());
+	intern_pool(const intern_pool&) = delete;
+	intern_pool& operator=(const intern_pool&) = delete;
+
+	/// Returns a handle to the canonical object, equal to value. If there is
+	/// none, value becomes canonical. Returns an empty handle if value is empty.
+	handle intern(poly_type value);
+
+	/// Number of canonical objects
+	std::size_t size() const;
+
+private:
+	struct node {
+		poly_type value;
+		std::size_t hash;
+	};
+
+	struct slot {
+		node* ptr;
+		std::weak_ptr<node> ref;
+	};
+
+	struct shard {
+		std::mutex mutex;
+		std::unordered_multimap<std::size_t, slot> slots;
+	};
+
+	/// Removes the node from its shard when the last handle is destroyed
+	struct node_deleter {
+		std::shared_ptr<shard> owner;
+
+		void operator()(node* ptr) const;
+	};
+
+	std::size_t hash_of(const Base& obj) const;
+
+	/// Returns a handle to an object in s, equal to obj, or an empty handle.
+	/// s must be locked.
+	handle find(shard& s, std::size_t h, const Base& obj) const;
+
+	Hash hash;
+	Equal equal;
+	std::vector<std::shared_ptr<shard>> shards;
+};
+
+} // namespace pl
+
+#include "intern_pool.inl"
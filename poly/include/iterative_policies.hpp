@@ -0,0 +1,126 @@
+#pragma once
+#include <cstddef>     // size_t
+#include <type_traits> // remove_const
+#include <utility>     // pair
+#include <vector>      // vector
+
+namespace pl {
+namespace detail {
+
+/// A deferred copy: copies source, and stores the copy in the poly, that
+/// target points to. Until then, the poly holds the index of the task,
+/// tagged by the lowest bit, so that adopt can follow it when it's moved.
+struct clone_task {
+	void* target;       // Base** of the poly, set by adopt. nullptr if dropped.
+	const void* source; // const Base*
+	void (*run)(const clone_task& task);
+	/// Makes the poly hold the index of the task, or nullptr if index is npos
+	void (*relink)(const clone_task& task, std::size_t index);
+	void (*clone)();    // Type-erased clone function of the poly's policy
+
+	static constexpr std::size_t npos = static_cast<std::size_t>(-1);
+};
+
+/// Copies of most derived objects by the address of their originals. Open
+/// addressing, as it's only filled during one copy, and never erased from.
+class clone_memo {
+public:
+	clone_memo() noexcept;
+
+	/// Makes room for one more copy, so that insert doesn't throw
+	void reserve_one();
+	void insert(const void* source, void* copy) noexcept;
+	void* find(const void* source) const noexcept;
+
+private:
+	std::size_t slot_of(const void* source) const noexcept;
+
+	std::vector<std::pair<const void*, void*>> slots; // Empty ones have no source
+	std::size_t count;
+};
+
+/// State of the outermost copy by an iterative policy, which keeps it on its
+/// stack. Objects, reached while another object is copied, are put into
+/// clone_list, which the outermost copy goes through in a loop.
+struct clone_state {
+	std::vector<clone_task> clone_list;
+	clone_memo copies;
+};
+
+/// The state of the copy in progress on this thread, or nullptr
+clone_state*& iterative_cloning() noexcept;
+
+/// Per-thread state of iterative_delete. Objects, reached while another
+/// object is destroyed, are put into destroy_list, which the outermost
+/// destroy goes through in a loop.
+struct iterative_state {
+	bool destroying;
+	std::vector<std::pair<const void*, void (*)(const void*)>> destroy_list;
+};
+
+iterative_state& iterative_local();
+
+} // namespace detail
+
+// Policies for self-referential structures, like linked lists and trees,
+// whose objects own other objects of the same kind through polys. Usual
+// policies destroy and copy such structures recursively, one stack frame
+// per level, so long chains overflow the stack.
+// With these policies, an object, reached while another object is being
+// destroyed or copied, is put into a worklist instead. The outermost
+// destroy or copy then goes through the worklist in a loop, so the stack
+// depth doesn't grow with the depth of the structure.
+// Objects can be of any type, but all polys in the structure must use the
+// iterative policies. During a copy, child polys hold a placeholder until
+// the copy constructor of their parent returns. The copy constructor can
+// copy, move and destroy them, like when it fills a std::vector, but must
+// not look into them, or convert them to polys of another Base.
+
+/// Copies the object, deferring copies of objects it owns. If Memo is true,
+/// iterative_clone_of finds copies of objects, made during the same copy.
+template <class Base, bool Memo = false>
+class iterative_copy {
+public:
+	constexpr iterative_copy() noexcept;
+
+	template <class Base2>
+	iterative_copy(const iterative_copy<Base2, Memo>& other) noexcept;
+
+	template <class Derived>
+	iterative_copy(const Derived*);
+
+	Base* operator()(const Base* other);
+
+private:
+	typename std::remove_const<Base>::type* (*clone_ptr)(const Base*);
+
+	template <class Base2, bool Memo2>
+	friend class iterative_copy;
+};
+
+/// Deletes the object, deferring deletion of objects it owns
+template <class Base>
+class iterative_delete {
+public:
+	constexpr iterative_delete() noexcept = default;
+
+	template <class Base2>
+	iterative_delete(const iterative_delete<Base2>&) noexcept;
+
+	void operator()(const Base* ptr) const;
+
+	/// Called by poly after a copy or move. Gives a deferred copy the poly
+	/// to go to.
+	void adopt(Base*& data) const noexcept;
+};
+
+/// During a copy by an iterative policy with Memo, returns the copy of
+/// source, if it's already made, or nullptr. Copies of all ancestors of the
+/// object, that is being copied, are already made, so copy constructors
+/// can use it to remap pointers to them, like pointers to parents.
+template <class T>
+T* iterative_clone_of(const T* source);
+
+} // namespace pl
+
+#include "iterative_policies.inl"
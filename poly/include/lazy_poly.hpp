@@ -0,0 +1,63 @@
+#pragma once
+#include <atomic> // atomic
+#include <mutex>  // mutex
+#include <string> // string
+#include "factory.hpp"
+
+namespace pl {
+
+/// A poly, that is made by a factory on first access.
+/// The factory must outlive the lazy_poly. Access from multiple threads is
+/// safe: the object is made once, and after that get() is a single atomic
+/// load. Copying and assignment are not thread-safe, same as for poly.
+template <class Base, class CopyDeletePolicy = deep<Base>>
+class lazy_poly {
+public:
+	using base_type = Base;
+	using policy = CopyDeletePolicy;
+	using poly_type = poly<Base, CopyDeletePolicy>;
+	using factory_type = factory<Base, CopyDeletePolicy>;
+
+	// Construction ============================================================
+	lazy_poly() noexcept;
+	lazy_poly(const factory_type& f, std::string name);
+
+	/// Copies are made lazily as well, unless other is already made
+	lazy_poly(const lazy_poly& other);
+	lazy_poly(lazy_poly&& other) noexcept;
+	lazy_poly& operator=(const lazy_poly& other);
+	lazy_poly& operator=(lazy_poly&& other) noexcept;
+
+	// Observers ===============================================================
+	/// Checks if the object is of type T. Does not make the object.
+	template <class T>
+	bool is() const;
+
+	/// Checks if the object was already made
+	bool constructed() const noexcept;
+
+	const std::string& name() const noexcept;
+
+	// Member access ===========================================================
+	// All of these make the object, if it wasn't made yet.
+	Base& operator*() const;
+	Base* operator->() const;
+	Base* get() const;
+
+	template <class T>
+	T* as() const;
+
+private:
+	Base* construct() const;
+
+	const factory_type* source;
+	std::string type_name;
+
+	mutable std::mutex init_mutex;
+	mutable poly_type value;
+	mutable std::atomic<Base*> cache;
+};
+
+} // namespace pl
+
+#include "lazy_poly.inl"
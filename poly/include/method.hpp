@@ -0,0 +1,39 @@
+#pragma once
+
+namespace pl {
+
+/// Base for a method, used by any_of and bound_method. Signature is a function
+/// type, like double() const or void(int). A method derives from this class
+/// and provides a static function template call(T& obj, Args...), that calls
+/// the method on obj:
+/// struct area : pl::method<double() const> {
+///     template <class T>
+///     static double call(const T& obj) { return obj.area(); }
+/// };
+template <class Signature>
+struct method;
+
+template <class R, class... Args>
+struct method<R(Args...)> {
+	using result_type = R;
+	using thunk_type = R(*)(void*, Args...);
+	static constexpr bool is_const = false;
+};
+
+template <class R, class... Args>
+struct method<R(Args...) const> {
+	using result_type = R;
+	using thunk_type = R(*)(const void*, Args...);
+	static constexpr bool is_const = true;
+};
+
+namespace detail {
+
+/// Calls Method on an object of type T, passed as void*
+template <class Method, class T, class Thunk>
+struct method_thunk;
+
+} // namespace detail
+} // namespace pl
+
+#include "method.inl"
@@ -0,0 +1,105 @@
+#pragma once
+#include <atomic>             // atomic
+#include <condition_variable> // condition_variable
+#include <cstddef>            // size_t
+#include <deque>              // deque
+#include <exception>          // exception_ptr
+#include <functional>         // function
+#include <memory>             // unique_ptr
+#include <mutex>              // mutex
+#include <thread>             // thread
+#include <vector>             // vector
+
+namespace pl {
+
+/// A fixed-size pool of threads with a task queue per thread.
+/// Idle threads steal tasks from the queues of other threads.
+/// Any class with execute(std::function<void()>) can be used by parallel
+/// functions instead. If that class also has size(), it's used as the
+/// number of threads to split work between.
+class thread_pool {
+public:
+	explicit thread_pool(std::size_t threads = std::thread::hardware_concurrency());
+	thread_pool(const thread_pool&) = delete;
+	thread_pool& operator=(const thread_pool&) = delete;
+
+	/// Runs all remaining tasks and joins the threads
+	~thread_pool();
+
+	std::size_t size() const noexcept;
+	void execute(std::function<void()> task);
+
+private:
+	struct task_queue {
+		std::mutex mutex;
+		std::deque<std::function<void()>> tasks;
+	};
+
+	void work(std::size_t index);
+	bool try_pop(std::size_t index, std::function<void()>& task);
+
+	std::vector<std::unique_ptr<task_queue>> queues;
+	std::vector<std::thread> threads;
+	std::atomic<std::size_t> next_queue;
+
+	// Guards pending and stopping, idle threads wait on wake. Held while a
+	// task is pushed, so that pending counts it before it can be popped.
+	std::mutex state_mutex;
+	std::condition_variable wake;
+	std::size_t pending;
+	bool stopping;
+};
+
+/// Pool, used by parallel functions when no executor is given.
+/// Has one thread per hardware thread, created on first use.
+thread_pool& default_pool();
+
+namespace detail {
+
+/// Counts down finished tasks, rethrows the first exception, thrown in them
+class task_group {
+public:
+	explicit task_group(std::size_t count) noexcept;
+
+	void done(std::exception_ptr error = nullptr);
+	void wait();
+
+private:
+	std::mutex mutex;
+	std::condition_variable finished;
+	std::size_t remaining;
+	std::exception_ptr first_error;
+};
+
+/// Splits [0, n) into chunks and calls f(first, last) for each chunk on
+/// the executor. Returns when all chunks are done. Must not be called from
+/// a task, running on the same executor.
+template <class Executor, class F>
+void parallel_for(Executor& executor, std::size_t n, F f);
+
+} // namespace detail
+
+// Parallel make ===============================================================
+// Makes a poly for every name in names and assigns it to out[i], splitting
+// the work between executor's threads. Objects are allocated on the threads
+// that construct them. Returns out + size of names.
+
+template <class Factory, class NameRange, class RandomIt, class Executor>
+RandomIt parallel_make(const Factory& f, const NameRange& names, RandomIt out,
+	Executor& executor);
+
+template <class Factory, class NameRange, class RandomIt>
+RandomIt parallel_make(const Factory& f, const NameRange& names, RandomIt out);
+
+// Parallel destroy ============================================================
+// Resets every poly in range, splitting the work between executor's threads.
+
+template <class Range, class Executor>
+void parallel_destroy(Range& range, Executor& executor);
+
+template <class Range>
+void parallel_destroy(Range& range);
+
+} // namespace pl
+
+#include "parallel.inl"
@@ -0,0 +1,135 @@
+#pragma once
+#include <cstddef>  // size_t
+#include <iterator> // begin, end
+#include <typeinfo> // type_info
+#include <vector>   // vector
+#include "dispatch.hpp"
+#include "parallel.hpp"
+
+namespace pl {
+namespace detail {
+
+/// Groups positions of non-empty polys in a range by the dynamic type of
+/// their objects, using the same identity as poly::is<T>().
+template <class It>
+class type_buckets {
+public:
+	struct bucket {
+		const std::type_info* type;
+		std::vector<std::size_t> indices;
+	};
+
+	type_buckets(It first, std::size_t n);
+
+	std::vector<bucket> buckets;
+};
+
+/// Splits buckets of a range into chunks, a few per thread in total.
+/// Within a chunk all objects have the same type.
+template <class It>
+struct chunk_plan {
+	struct chunk {
+		std::size_t type; // Position of the type in a type_list, or its size
+		const std::size_t* first;
+		const std::size_t* last;
+	};
+
+	type_buckets<It> buckets;
+	std::vector<chunk> chunks;
+};
+
+template <class List, class Executor, class It>
+chunk_plan<It> plan_chunks(Executor& executor, It first, std::size_t n);
+
+/// Calls visitor(chunk, index, obj) on the executor for every object in
+/// the plan. If the object's type is in List, obj is downcast to it,
+/// otherwise obj is a reference to the poly's base type.
+template <class List, class Executor, class It, class Visitor>
+void visit_chunks(Executor& executor, It first, const chunk_plan<It>& plan,
+	Visitor& visitor);
+
+} // namespace detail
+
+// Parallel algorithms over ranges of polys. Elements are first grouped by
+// the dynamic type of their objects, then every group is processed in
+// parallel chunks. Within a chunk the same function is called for the same
+// type, so virtual calls are predictable.
+// Versions with List call handlers with objects downcast to their exact
+// type, if that type is in List, and with Base& otherwise.
+// Empty polys are skipped. Algorithms without an executor use default_pool().
+namespace par {
+
+// for_each ====================================================================
+// Calls f(obj) for every object. Order of calls is unspecified.
+
+template <class Range, class F>
+void for_each(Range& range, F f);
+
+template <class Range, class F, class Executor>
+void for_each(Range& range, F f, Executor& executor);
+
+template <class List, class Range, class Handlers>
+void for_each(Range& range, Handlers handlers);
+
+template <class List, class Range, class Handlers, class Executor>
+void for_each(Range& range, Handlers handlers, Executor& executor);
+
+// transform_reduce ============================================================
+// Returns init reduced with transform(obj) of every object. Reduce must be
+// associative and commutative, as the order of reduction is unspecified.
+
+template <class Range, class T, class Reduce, class Transform>
+T transform_reduce(Range& range, T init, Reduce reduce, Transform transform);
+
+template <class Range, class T, class Reduce, class Transform, class Executor>
+T transform_reduce(Range& range, T init, Reduce reduce, Transform transform,
+	Executor& executor);
+
+template <class List, class Range, class T, class Reduce, class Transform>
+T transform_reduce(Range& range, T init, Reduce reduce, Transform transform);
+
+template <class List, class Range, class T, class Reduce, class Transform,
+	class Executor>
+T transform_reduce(Range& range, T init, Reduce reduce, Transform transform,
+	Executor& executor);
+
+// partition ===================================================================
+// Moves polys for which pred(obj) is true before the others and returns an
+// iterator to the first of the others. Empty polys count as false, so they
+// end up among the others.
+// pred is evaluated in parallel, polys are moved on the calling thread.
+// partition swaps polys in place; stable_partition keeps the relative order
+// of polys in both groups, at the cost of a temporary buffer.
+
+template <class Range, class Pred>
+auto partition(Range& range, Pred pred) -> decltype(std::begin(range));
+
+template <class Range, class Pred, class Executor>
+auto partition(Range& range, Pred pred, Executor& executor)
+-> decltype(std::begin(range));
+
+template <class List, class Range, class Pred>
+auto partition(Range& range, Pred pred) -> decltype(std::begin(range));
+
+template <class List, class Range, class Pred, class Executor>
+auto partition(Range& range, Pred pred, Executor& executor)
+-> decltype(std::begin(range));
+
+template <class Range, class Pred>
+auto stable_partition(Range& range, Pred pred) -> decltype(std::begin(range));
+
+template <class Range, class Pred, class Executor>
+auto stable_partition(Range& range, Pred pred, Executor& executor)
+-> decltype(std::begin(range));
+
+template <class List, class Range, class Pred>
+auto stable_partition(Range& range, Pred pred) -> decltype(std::begin(range));
+
+template <class List, class Range, class Pred, class Executor>
+auto stable_partition(Range& range, Pred pred, Executor& executor)
+-> decltype(std::begin(range));
+
+} // namespace par
+} // namespace pl
+
+#include "parallel_algorithm.inl"
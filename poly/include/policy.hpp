@@ -1,7 +1,12 @@
 #pragma once
+#include "aligned_policies.hpp"
+#include "compacting_arena.hpp"
 #include "compound.hpp"
 #include "copy_policies.hpp"
 #include "delete_policies.hpp"
+#include "iterative_policies.hpp"
+#include "recycling_policies.hpp"
+#include "registry_policies.hpp"
 
 namespace pl {
 // Default poliices, provided with the library.
@@ -14,4 +19,36 @@ using unique = compound<no_copy, default_delete<Base>>;
 template <class Base>
 using deep = compound<deep_copy<Base>, default_delete<Base>>;
 
+// Same as deep, but finds the clone function by the object's dynamic type
+// instead of storing it, so poly stays the size of a pointer.
+template <class Base>
+using slim = compound<registry_copy<Base>, default_delete<Base>>;
+
+// Destroys the object without freeing its memory, for objects made in memory
+// owned by someone else. Not copyable.
+template <class Base>
+using in_place = compound<no_copy, in_place_delete<Base>>;
+
+// Same as deep, but every object is placed on its own cache lines (or at
+// Align boundaries), so objects, used by different threads, don't share them.
+template <class Base, std::size_t Align = cache_line_size>
+using aligned = compound<aligned_copy<Base, Align>, aligned_delete<Base, Align>>;
+
+// Same as deep, but objects are placed in default_arena<Base>(), which can
+// move them together with compact(). Not trivially relocatable.
+template <class Base>
+using compacting = compound<arena_copy<Base>, arena_delete<Base>>;
+
+// Same as deep, but memory of destroyed objects is kept in thread-local free
+// lists, and reused for new objects of similar size.
+template <class Base>
+using recycling = compound<recycling_copy<Base>, recycling_delete<Base>>;
+
+// Same as deep, but objects, owned by an object that is destroyed or copied,
+// are destroyed or copied in a loop instead of recursively, so long chains
+// of polys don't overflow the stack. Memo enables iterative_clone_of. Not
+// trivially relocatable.
+template <class Base, bool Memo = false>
+using iterative = compound<iterative_copy<Base, Memo>, iterative_delete<Base>>;
+
 } // namespace pl
\ No newline at end of file
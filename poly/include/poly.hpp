@@ -8,11 +8,23 @@
 #include <type_traits> // has_virtual_destructor, enable_if, is_base_of
 #include <utility>     // forward
 
+#include "cast_table.hpp"
 #include "policy.hpp"
 #include "traits.hpp"
 
 namespace pl {
 
+namespace detail {
+
+/// Selects the constructor, that adopts an object made by the policy's create
+struct created_t {};
+
+/// Builds a poly from an object, that the create of its policy made
+template <class PolyType, class Derived>
+PolyType from_created(Derived* obj);
+
+} // namespace detail
+
 template<class Base, class CopyDeletePolicy = deep<Base>>
 class poly : private CopyDeletePolicy {
 	// Static check performed in constructors instead for late evaluation.
@@ -45,6 +57,8 @@ public:
 	poly(poly<Base2, CopyDeletePolicy2>&& other) noexcept;
 
 	// From a pointer ----------------------------------------------------------
+	// Not available for policies with their own create, which can't adopt
+	// objects made with new. Use make instead.
 	template <class Derived>
 	explicit poly(Derived* obj);
 	template <class Derived>
@@ -60,6 +74,7 @@ public:
 	explicit constexpr operator bool() const noexcept;
 
 	// Modifiers ===============================================================
+	/// Not available for policies with their own create, as poly(obj)
 	template <class Derived>
 	void reset(Derived* obj);
 	void reset(std::nullptr_t = nullptr) noexcept;
@@ -74,14 +89,61 @@ public:
 	template <class T>
 	T* as() const noexcept;
 
+	template <class T>
+	T* as_base() const;
+
 	// Friends =================================================================
 	template<class Base2, class CopyDeletePolicy2>
 	friend class poly;
 
+	template <class PolyType, class Base2, class CopyDeletePolicy2>
+	friend PolyType cast(poly<Base2, CopyDeletePolicy2>&& other);
+
+	template <class PolyType, class Derived>
+	friend PolyType detail::from_created(Derived* obj);
+
 private:
+	template <class Derived>
+	poly(detail::created_t, Derived* obj);
+
+	/// Tell the policy, that this poly owns data, or doesn't own it anymore
+	void adopt() noexcept;
+	void forget() noexcept;
+
 	Base* data;
 };
 
+namespace detail {
+
+/// Checks if a policy makes objects itself with a static create<T>(args...)
+template <class Policy>
+struct has_create_impl;
+
+template <class Policy>
+struct has_create : has_create_impl<Policy>::type {
+};
+
+/// Checks if two policies free objects with the same deleter template, for
+/// any Base, so that one can take over objects of the other
+template <class Policy1, class Policy2>
+struct same_deleter;
+
+/// Calls adopt or forget of a policy, that tracks the polys of its objects.
+/// Does nothing for other policies.
+template <class Policy, class T>
+auto policy_adopt(Policy& policy, T*& data, int) noexcept
+-> decltype(policy.adopt(data));
+template <class Policy, class T>
+void policy_adopt(Policy& policy, T*& data, long) noexcept;
+
+template <class Policy, class T>
+auto policy_forget(Policy& policy, T* data, int) noexcept
+-> decltype(policy.forget(data));
+template <class Policy, class T>
+void policy_forget(Policy& policy, T* data, long) noexcept;
+
+} // namespace detail
+
 // Make ========================================================================
 
 template <class PolyType, class Derived, class... Args>
@@ -97,6 +159,11 @@ template <class PolyType, class Derived,
 	class OldBase, class CopyDeletePolicy>
 inline PolyType transform(poly<OldBase, CopyDeletePolicy>&& other);
 
+// Cast ========================================================================
+
+template <class PolyType, class OldBase, class CopyDeletePolicy>
+inline PolyType cast(poly<OldBase, CopyDeletePolicy>&& other);
+
 // Comparison operators ========================================================
 
 template<class B1, class P1, class B2, class P2>
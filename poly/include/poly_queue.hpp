@@ -0,0 +1,72 @@
+#pragma once
+#include <cstddef>     // size_t
+#include <type_traits> // conditional, is_same
+#include "bounded_queue.hpp"
+#include "policy.hpp"
+#include "poly.hpp"
+
+namespace pl {
+
+/// Concurrency of a poly_queue: one producer thread and one consumer thread
+struct spsc {};
+/// Concurrency of a poly_queue: any number of producers and consumers
+struct mpmc {};
+
+/// A bounded lock-free queue, that moves polys between threads.
+/// Polys are moved into a ring of preallocated cells, which are reused on
+/// every lap, so pushing and popping never allocates. Only ownership of the
+/// object is transferred, the object itself is not copied or moved.
+/// Concurrency is spsc or mpmc. An spsc queue is faster, but only one thread
+/// may push, and only one thread may pop, at a time.
+template <class Base, class CopyDeletePolicy = unique<Base>, class Concurrency = mpmc>
+class poly_queue {
+	static_assert(std::is_same<Concurrency, spsc>::value ||
+		std::is_same<Concurrency, mpmc>::value,
+		"poly_queue: Concurrency must be spsc or mpmc");
+public:
+	using value_type = poly<Base, CopyDeletePolicy>;
+	using concurrency = Concurrency;
+
+	/// Capacity is rounded up to a power of two
+	explicit poly_queue(std::size_t capacity);
+
+	// Non-blocking ============================================================
+
+	/// Returns false if the queue is full, value is left untouched
+	bool try_push(value_type& value) noexcept;
+	/// Returns false if the queue is empty, or another consumer is popping
+	/// from it, value is left untouched
+	bool try_pop(value_type& value) noexcept;
+
+	/// Moves polys from [first, last) into the queue, until it's full.
+	/// Returns the iterator past the last pushed poly. It is a forward
+	/// iterator.
+	template <class It>
+	It try_push(It first, It last) noexcept;
+	/// Moves up to max polys to out, returns how many were popped. If out
+	/// throws, polys that were not moved out yet stay in the queue.
+	template <class OutputIt>
+	std::size_t try_pop(OutputIt out, std::size_t max);
+
+	// Blocking ================================================================
+	// Yield to other threads while the queue is full or empty.
+
+	void push(value_type value) noexcept;
+	value_type pop() noexcept;
+
+	/// Pushes all polys from [first, last)
+	template <class It>
+	void push(It first, It last) noexcept;
+
+	// Observers ===============================================================
+	std::size_t capacity() const noexcept;
+
+private:
+	typename std::conditional<std::is_same<Concurrency, spsc>::value,
+		detail::spsc_queue<value_type>,
+		detail::bounded_queue<value_type>>::type queue;
+};
+
+} // namespace pl
+
+#include "poly_queue.inl"
@@ -0,0 +1,99 @@
+#pragma once
+#include <cstddef> // size_t
+#include <cstdint> // uint32_t, uint64_t
+#include <vector>  // vector
+#include "policy.hpp"
+#include "poly.hpp"
+#include "vector.hpp"
+
+namespace pl {
+
+/// A container of polys, that refers to them with stable handles.
+/// Polys are stored in one dense array, in no particular order, so that
+/// iteration is linear. Handles are 64-bit: the low 32 bits are the index
+/// of a slot, that points into the dense array, and the high 32 bits are the
+/// generation of the slot, which changes every time its poly is erased.
+/// A handle of an erased poly is stale, and is never valid again, unless the
+/// generation of its slot wraps around after 2^31 erasures.
+/// Insertion, erasure and lookup are O(1). Erasure moves the last poly into
+/// the place of the erased one, which invalidates pointers and iterators,
+/// but not handles.
+template <class Base, class CopyDeletePolicy = deep<Base>>
+class poly_slot_map {
+public:
+	using value_type = poly<Base, CopyDeletePolicy>;
+	using size_type = std::size_t;
+	using handle = std::uint64_t;
+	using iterator = value_type*;
+	using const_iterator = const value_type*;
+
+	/// A handle, that is never valid
+	static constexpr handle null_handle = 0;
+
+	// Construction ============================================================
+	poly_slot_map();
+
+	// Iterators ===============================================================
+	iterator begin() noexcept;
+	const_iterator begin() const noexcept;
+	iterator end() noexcept;
+	const_iterator end() const noexcept;
+
+	// Capacity ================================================================
+	bool empty() const noexcept;
+	size_type size() const noexcept;
+	void reserve(size_type new_capacity);
+
+	// Lookup ==================================================================
+	bool contains(handle h) const noexcept;
+
+	/// Returns the poly of a handle, or nullptr if the handle is stale
+	value_type* find(handle h) noexcept;
+	const value_type* find(handle h) const noexcept;
+
+	/// Throw std::out_of_range if the handle is stale
+	value_type& at(handle h);
+	const value_type& at(handle h) const;
+
+	/// Returns the object of a handle as T, like poly::as<T>(), or nullptr
+	/// if the handle is stale
+	template <class T>
+	T* get(handle h) const noexcept;
+
+	/// Returns the handle of the poly at position i of the dense array
+	handle handle_of(size_type i) const;
+
+	// Modifiers ===============================================================
+	handle insert(value_type value);
+	template <class Derived, class... Args>
+	handle emplace(Args&&... args);
+
+	/// Erases the poly of a handle. Returns false if the handle is stale.
+	bool erase(handle h);
+	void clear() noexcept;
+
+private:
+	struct slot {
+		std::uint32_t index;      // Position in values, or the next free slot
+		std::uint32_t generation; // Odd if the slot is in use
+	};
+
+	static constexpr std::uint32_t no_slot = 0xFFFFFFFF;
+
+	static handle make_handle(std::uint32_t index, std::uint32_t generation) noexcept;
+
+	/// Returns the slot of a handle, or nullptr if the handle is stale
+	const slot* live_slot(handle h) const noexcept;
+
+	/// Marks a slot as free, and adds it to the free list
+	void release(std::uint32_t s) noexcept;
+
+	pl::vector<value_type> values;
+	std::vector<std::uint32_t> owners; // Slot of every poly in values
+	std::vector<slot> slots;
+	std::uint32_t free_head; // First free slot, or no_slot
+};
+
+} // namespace pl
+
+#include "poly_slot_map.inl"
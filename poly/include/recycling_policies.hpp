@@ -0,0 +1,144 @@
+#pragma once
+#include <atomic>      // atomic
+#include <cstddef>     // size_t, max_align_t
+#include <cstdint>     // uint64_t
+#include <type_traits> // remove_const
+
+namespace pl {
+
+/// Allocation statistics of the recycling policies, summed over all threads
+struct recycling_statistics {
+	std::uint64_t hits;         // Allocations, served from a free list
+	std::uint64_t misses;       // Allocations, that needed a new slab or operator new
+	std::uint64_t remote_frees; // Objects, freed on another thread than they were made on
+
+	/// Share of allocations, served from a free list, or 0 if there were none
+	double hit_rate() const noexcept;
+};
+
+recycling_statistics recycling_stats() noexcept;
+
+namespace detail {
+
+/// Recycles memory of freed objects through thread-local free lists, one per
+/// size class, which are refilled by carving fixed-size slabs.
+/// An object freed on the thread that made it goes straight back to that
+/// thread's free list. An object freed on another thread is pushed to a
+/// lock-free remote list of the thread that made it, which is moved to its
+/// free lists when they run empty.
+/// Memory is never returned to the system: thread caches outlive their
+/// threads, and are reused by new threads.
+class slab_recycler {
+public:
+	/// Objects with a stronger alignment requirement can't be stored
+	static constexpr std::size_t max_align = alignof(std::max_align_t);
+	/// Size classes are multiples of granularity bytes, including the header
+	static constexpr std::size_t granularity = max_align;
+	static constexpr std::size_t max_block_size = 1024;
+	static constexpr std::size_t class_count = max_block_size / granularity;
+	static constexpr std::size_t slab_size = 64 * 1024;
+
+	/// Recycler shared by all threads. Never destroyed, so that objects can
+	/// be freed during static destruction.
+	static slab_recycler& instance();
+
+	/// Returns memory for size bytes at a max_align boundary. Larger objects
+	/// are allocated with operator new.
+	void* allocate(std::size_t size);
+	/// Frees memory, returned by allocate, on any thread
+	void deallocate(void* ptr) noexcept;
+
+	recycling_statistics statistics() const noexcept;
+
+private:
+	struct cache;
+
+	struct alignas(std::max_align_t) header {
+		cache* owner;           // nullptr if allocated with operator new
+		std::size_t size_class;
+	};
+
+	/// A free block. next overlays the object.
+	struct node {
+		header h;
+		node* next;
+	};
+
+	/// Per-thread state. Counters are only written by the owner thread,
+	/// except remote_frees.
+	struct cache {
+		node* free_lists[class_count];
+		std::atomic<node*> remote;
+		std::atomic<bool> in_use;
+		cache* next;
+
+		std::atomic<std::uint64_t> hits;
+		std::atomic<std::uint64_t> misses;
+		std::atomic<std::uint64_t> remote_frees;
+	};
+
+	slab_recycler() noexcept;
+
+	/// Cache of the calling thread, or nullptr if it has none
+	static cache*& thread_cache() noexcept;
+	/// Cache of the calling thread, acquired on first use
+	cache* local();
+	cache* acquire();
+
+	/// Moves blocks, freed by other threads, to the free lists of c
+	static void drain(cache* c) noexcept;
+	/// Carves a new slab into blocks of a size class
+	static void refill(cache* c, std::size_t size_class);
+	/// Adds 1 to a counter, that only the calling thread writes
+	static void increment(std::atomic<std::uint64_t>& counter) noexcept;
+
+	std::atomic<cache*> caches;
+};
+
+} // namespace detail
+
+// Policies that recycle the memory of destroyed objects for new objects of
+// similar size, through thread-local free lists, instead of the general
+// allocator. Objects must be made with pl::make, which allocates through the
+// policy, and their alignment must not exceed max_align_t.
+
+/// Stores a pointer to a function that copies the object into recycled memory
+template <class Base>
+class recycling_copy {
+public:
+	constexpr recycling_copy() noexcept;
+
+	template <class Base2>
+	recycling_copy(const recycling_copy<Base2>& other) noexcept;
+
+	template <class Derived>
+	recycling_copy(const Derived*);
+
+	Base* operator()(const Base* other);
+
+private:
+	typename std::remove_const<Base>::type* (*clone_ptr)(const Base*);
+
+	template <class Base2>
+	friend class recycling_copy;
+};
+
+/// Destroys the object and recycles its memory
+template <class Base>
+class recycling_delete {
+public:
+	constexpr recycling_delete() noexcept = default;
+
+	template <class Base2>
+	recycling_delete(const recycling_delete<Base2>&) noexcept;
+
+	/// Makes an object in recycled memory, used by pl::make
+	template <class Derived, class... Args>
+	static Derived* create(Args&&... args);
+
+	void operator()(const Base* ptr) const;
+};
+
+} // namespace pl
+
+#include "recycling_policies.inl"
@@ -0,0 +1,28 @@
+#pragma once
+#include <type_traits>
+#include "type_registry.hpp"
+
+namespace pl {
+
+// registry_copy holds no state. Instead, on adoption it registers the
+// derived type in detail::type_registry, and on copy it looks it up by the
+// dynamic type of the object, whatever the base it was registered for.
+
+/// Copies the object using a clone function, found by its dynamic type
+template <class Base>
+class registry_copy {
+public:
+	constexpr registry_copy() noexcept = default;
+
+	template <class Base2>
+	registry_copy(const registry_copy<Base2>& other) noexcept;
+
+	template <class Derived>
+	registry_copy(const Derived*);
+
+	Base* operator()(const Base* other) const;
+};
+
+} // namespace pl
+
+#include "registry_policies.inl"
@@ -0,0 +1,53 @@
+#pragma once
+#include <type_traits> // integral_constant, is_trivially_copyable
+#include "compound.hpp"
+#include "poly.hpp"
+
+namespace pl {
+
+/// Checks if an object of type T can be moved to another address by copying
+/// its bytes, and then not destroying the original. True for trivially
+/// copyable types, poly and compound, unless the policy is compacting or
+/// iterative.
+/// Specialize it for other types.
+template <class T>
+struct is_trivially_relocatable : std::is_trivially_copyable<T> {
+};
+
+template <class Cloner, class Deleter>
+struct is_trivially_relocatable<compound<Cloner, Deleter>>
+	: std::integral_constant<bool,
+	is_trivially_relocatable<Cloner>::value &&
+	is_trivially_relocatable<Deleter>::value> {
+};
+
+/// The arena keeps the address of the poly, that owns each object
+template <class Base>
+struct is_trivially_relocatable<arena_delete<Base>> : std::false_type {
+};
+
+/// Deferred copies keep the address of the poly, that waits for them
+template <class Base>
+struct is_trivially_relocatable<iterative_delete<Base>> : std::false_type {
+};
+
+/// poly holds a pointer to the object, and never a pointer to itself
+template <class Base, class CopyDeletePolicy>
+struct is_trivially_relocatable<poly<Base, CopyDeletePolicy>>
+	: is_trivially_relocatable<CopyDeletePolicy> {
+};
+
+/// Moves objects from [first, last) to uninitialized memory at dest, and
+/// destroys the originals. The ranges may overlap if dest <= first.
+/// Trivially relocatable objects are moved with one memmove.
+/// Returns the end of the destination range.
+template <class T>
+T* relocate(T* first, T* last, T* dest);
+
+/// Same as relocate, but the ranges may overlap if dest >= first
+template <class T>
+T* relocate_backward(T* first, T* last, T* dest);
+
+} // namespace pl
+
+#include "relocate.inl"
@@ -0,0 +1,157 @@
+#pragma once
+#include <atomic>      // atomic
+#include <cstddef>     // size_t, max_align_t
+#include <type_traits> // remove_const
+#include "compound.hpp"
+
+// Shared memory is only available on POSIX systems. Elsewhere, shared_arena
+// throws on construction.
+#if defined(__unix__) || defined(__APPLE__)
+#define POLY_SHARED_MEMORY
+#endif
+
+namespace pl {
+
+/// An arena in memory, that is shared with child processes, forked after it
+/// is made. Objects, that a process makes in it before fork(), can be used
+/// by all children through the polys they inherit, as the arena is mapped
+/// at the same address, and vtables of the same binary match.
+/// The arena has a fixed capacity. Objects are placed one after another by
+/// a lock-free counter, so every process can make objects, but memory of
+/// destroyed objects is not reused. Every object is preceded by a header
+/// with its offset in the arena and the process that made it. Only that
+/// process destroys it, so children can drop the polys they inherit
+/// without touching objects of their parent.
+/// Memory, that objects allocate outside the arena, like the buffer of a
+/// std::string, is private to each process once it is forked.
+class shared_arena {
+public:
+	/// Objects with a stronger alignment requirement can't be stored
+	static constexpr std::size_t max_align = alignof(std::max_align_t);
+
+	/// Maps capacity bytes of shared memory for objects. Throws
+	/// std::runtime_error if shared memory is not available.
+	explicit shared_arena(std::size_t capacity);
+	shared_arena(const shared_arena&) = delete;
+	shared_arena& operator=(const shared_arena&) = delete;
+
+	/// Unmaps the memory in this process. Objects in it are not destroyed.
+	~shared_arena();
+
+	// Statistics ==============================================================
+	std::size_t capacity() const noexcept;
+	/// Bytes, taken by objects and memory, made so far, including destroyed ones
+	std::size_t used() const noexcept;
+	/// Bytes, taken by live objects and their headers
+	std::size_t live() const noexcept;
+
+	// Memory ==================================================================
+
+	/// Returns size bytes at a max_align boundary, for data without a type,
+	/// like results of workers. Never freed. Throws std::bad_alloc if the
+	/// arena is full.
+	void* allocate(std::size_t size);
+	bool contains(const void* ptr) const noexcept;
+
+	/// Offset of ptr from the start of the arena, which is the same in every
+	/// process, that maps it. ptr must be in the arena.
+	std::size_t offset_of(const void* ptr) const noexcept;
+	/// Pointer at offset from the start of the arena
+	template <class T>
+	T* at(std::size_t offset) const noexcept;
+
+	// Objects =================================================================
+	// Used by the shared_memory policy.
+
+	template <class T, class... Args>
+	T* create(Args&&... args);
+	/// Copies obj into the arena, that holds obj
+	template <class T>
+	static T* copy(const T& obj);
+	/// Destroys obj, if it was made by the calling process
+	template <class Base>
+	static void destroy(const Base* obj) noexcept;
+
+private:
+	/// Start of the shared memory
+	struct alignas(std::max_align_t) control {
+		std::atomic<std::size_t> top;  // Bytes, taken from the start of the memory
+		std::atomic<std::size_t> live; // Bytes, taken by live objects
+		std::size_t size;              // Bytes in the memory
+	};
+
+	struct alignas(std::max_align_t) header {
+		std::size_t offset; // Of the header from the start of the memory
+		std::size_t size;   // Bytes, including the header
+		long maker;         // Id of the process, that made the object
+	};
+
+	/// Takes size bytes, rounded up to max_align, from c
+	static unsigned char* take(control* c, std::size_t size);
+	/// Makes a T with a header in c
+	template <class T, class... Args>
+	static T* construct(control* c, Args&&... args);
+
+	static header* header_of(const void* most_derived) noexcept;
+	static control* control_of(header* h) noexcept;
+	static long current_process() noexcept;
+
+	control* memory;
+};
+
+/// Makes Derived in arena, for polys with the shared_memory policy
+template <class PolyType, class Derived, class... Args>
+PolyType make(shared_arena& arena, Args&&... args);
+
+// Policies for objects in a shared_arena. Objects must be made with
+// pl::make(arena, args...), and copies are made in the arena of the
+// original.
+
+/// Stores a pointer to a function that copies the object into its arena
+template <class Base>
+class shared_arena_copy {
+public:
+	constexpr shared_arena_copy() noexcept;
+
+	template <class Base2>
+	shared_arena_copy(const shared_arena_copy<Base2>& other) noexcept;
+
+	template <class Derived>
+	shared_arena_copy(const Derived*);
+
+	Base* operator()(const Base* other);
+
+private:
+	typename std::remove_const<Base>::type* (*clone_ptr)(const Base*);
+
+	template <class Base2>
+	friend class shared_arena_copy;
+};
+
+/// Destroys the object, if the calling process made it
+template <class Base>
+class shared_arena_delete {
+public:
+	constexpr shared_arena_delete() noexcept = default;
+
+	template <class Base2>
+	shared_arena_delete(const shared_arena_delete<Base2>&) noexcept;
+
+	/// Fails to compile: objects need an arena, so pl::make(arena, args...)
+	/// must be used. Declared, so that objects of other policies are never
+	/// adopted.
+	template <class Derived, class... Args>
+	static Derived* create(Args&&... args);
+
+	void operator()(const Base* ptr) const;
+};
+
+// Same as deep, but objects are placed in a shared_arena, so that processes,
+// forked after they are made, can use them. Defined here rather than in
+// policy.hpp, so that poly.hpp doesn't include system headers.
+template <class Base>
+using shared_memory = compound<shared_arena_copy<Base>, shared_arena_delete<Base>>;
+
+} // namespace pl
+
+#include "shared_arena.inl"
@@ -0,0 +1,67 @@
+#pragma once
+#include <atomic>        // atomic
+#include <cstddef>       // size_t
+#include <deque>         // deque
+#include <functional>    // hash
+#include <memory>        // unique_ptr
+#include <mutex>         // mutex
+#include <vector>        // vector
+
+namespace pl {
+namespace detail {
+
+/// Grow-only hash map with lock-free lookups, for tables that are filled
+/// once per type and then read on every operation. Entries never move, and
+/// are linked into the buckets of an immutable-size table, which readers load
+/// through an atomic pointer. A writer links a new entry in place, or, when
+/// the table is full, publishes a table with twice the buckets. Replaced
+/// tables are kept alive for readers that may still walk them. Their sizes
+/// are a geometric series, so memory stays linear in the number of entries,
+/// and references to values stay valid for the lifetime of the map.
+template <class Key, class Value, class Hash = std::hash<Key>>
+class snapshot_map {
+public:
+	snapshot_map() noexcept;
+	snapshot_map(const snapshot_map&) = delete;
+	snapshot_map& operator=(const snapshot_map&) = delete;
+
+	/// Returns the value for key, or nullptr if there is none
+	const Value* find(const Key& key) const noexcept;
+
+	/// Inserts value if key is not in the map yet, returns the stored value
+	const Value& insert(const Key& key, const Value& value);
+
+private:
+	struct entry {
+		Key key;
+		Value value;
+	};
+
+	struct link {
+		const entry* item;
+		const link* next;
+	};
+
+	struct table {
+		explicit table(std::size_t bucket_count);
+
+		std::size_t mask; // Bucket count - 1
+		std::unique_ptr<std::atomic<const link*>[]> buckets;
+		std::deque<link> links; // Never move, so readers can follow them
+	};
+
+	static std::size_t bucket_of(const Key& key, std::size_t mask) noexcept;
+	/// Links item into t. Must be called under write_mutex.
+	void add(table& t, const entry* item);
+
+	std::atomic<const table*> current;
+
+	std::mutex write_mutex;
+	std::deque<entry> entries;
+	std::vector<std::unique_ptr<table>> tables;
+};
+
+} // namespace detail
+} // namespace pl
+
+#include "snapshot_map.inl"
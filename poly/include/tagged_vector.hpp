@@ -0,0 +1,109 @@
+#pragma once
+#include <cstddef>  // size_t
+#include <cstdint>  // uint8_t
+#include <typeinfo> // type_info
+#include <vector>   // vector
+#include "policy.hpp"
+#include "poly.hpp"
+#include "vector.hpp"
+
+namespace pl {
+namespace detail {
+
+// Tag scans ===================================================================
+// Scans an array of one-byte tags, 32 tags per step with AVX2, 16 with SSE2,
+// and one at a time if neither is available.
+
+/// Returns the number of tags, equal to tag
+std::size_t tag_count(const std::uint8_t* tags, std::size_t n, std::uint8_t tag) noexcept;
+
+/// Calls f(i) for every i in [0, n), where tags[i] == tag, in order
+template <class F>
+void tag_scan(const std::uint8_t* tags, std::size_t n, std::uint8_t tag, F&& f);
+
+} // namespace detail
+
+/// A vector of polys, that stores a one-byte tag of the dynamic type of
+/// every element in a separate dense array. Counting and finding objects of
+/// a type scans the tags, without touching the objects.
+/// Every dynamic type gets a tag when the first object of that type is
+/// inserted. At most max_types types can be stored in one tagged_vector.
+/// Elements are const, so that tags stay correct. Objects can be modified
+/// through the poly, but elements can only be replaced with set.
+template <class Base, class CopyDeletePolicy = deep<Base>>
+class tagged_vector {
+public:
+	using value_type = poly<Base, CopyDeletePolicy>;
+	using size_type = std::size_t;
+	using tag_type = std::uint8_t;
+	using const_iterator = const value_type*;
+
+	/// Tag of empty polys
+	static constexpr tag_type empty_tag = 0;
+	/// Tag of types, that are not in the vector
+	static constexpr tag_type no_tag = 255;
+	static constexpr std::size_t max_types = 254;
+
+	// Iterators ===============================================================
+	const_iterator begin() const noexcept;
+	const_iterator end() const noexcept;
+
+	// Capacity ================================================================
+	bool empty() const noexcept;
+	size_type size() const noexcept;
+	void reserve(size_type new_capacity);
+
+	// Element access ==========================================================
+	const value_type& operator[](size_type i) const;
+
+	// Tags ====================================================================
+	tag_type tag(size_type i) const;
+	/// Dense array of size() tags
+	const tag_type* tags() const noexcept;
+
+	/// Returns the tag of T, or no_tag if no object of type T was inserted
+	template <class T>
+	tag_type tag_of() const noexcept;
+	/// Returns the type of a tag, or nullptr for empty_tag and unknown tags
+	const std::type_info* type_of(tag_type tag) const noexcept;
+
+	// Queries =================================================================
+	// Objects of type T are the objects, for which poly::is<T>() is true.
+
+	template <class T>
+	size_type count() const noexcept;
+
+	/// Writes indices of all objects of type T to out, in order
+	template <class T, class OutputIt>
+	OutputIt find_all(OutputIt out) const;
+
+	// Modifiers ===============================================================
+	// Throw std::length_error if the vector would hold more than max_types
+	// types.
+
+	void push_back(value_type value);
+	template <class Derived, class... Args>
+	void emplace_back(Args&&... args);
+	void pop_back();
+
+	void set(size_type i, value_type value);
+	void erase(size_type i);
+	void clear() noexcept;
+
+	/// Moves all objects of type T to the front, keeping the order of the
+	/// other objects. Returns the number of objects of type T.
+	template <class T>
+	size_type partition();
+
+private:
+	/// Returns the tag of the object's type, adding the type if it's new
+	tag_type tag_for(const value_type& value);
+
+	pl::vector<value_type> values;
+	std::vector<tag_type> tag_array;
+	std::vector<const std::type_info*> types; // Type of tag i is types[i - 1]
+};
+
+} // namespace pl
+
+#include "tagged_vector.inl"
@@ -52,5 +52,7 @@ struct Der : Mid1, Mid2 {
 };
 
 struct Self_Ptr {
-	poly<Self_Ptr> val;
+	poly<Self_Ptr, pl::iterative<Self_Ptr>> val;
+
+	virtual ~Self_Ptr() = default;
 };
\ No newline at end of file
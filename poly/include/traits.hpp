@@ -1,7 +1,18 @@
 #pragma once
+#include <cstddef>     // size_t
 #include <type_traits>
 
 namespace pl {
+
+/// A list of types, used to pass several type packs to one template
+template <class... Ts>
+struct type_list {
+	static constexpr std::size_t size = sizeof...(Ts);
+};
+
+template <class... Ts>
+constexpr std::size_t type_list<Ts...>::size;
+
 namespace detail {
 
 // is_less_cv and is_more_cv - compare constraints of two types
@@ -60,5 +71,29 @@ struct defines_type<
 	T, typename enable_if_defined<typename T::type>::type> : std::true_type {
 };
 
+// same_const - T, const-qualified if U is const
+
+template <class U, class T>
+using same_const = typename std::conditional<
+	std::is_const<U>::value, const T, T>::type;
+
+// is_callable - checks that an object of type F can be called with Args
+
+template <class F, class... Args>
+struct is_callable_impl {
+	template <class G>
+	static auto test(int) -> decltype(
+		std::declval<G>()(std::declval<Args>()...), std::true_type());
+
+	template <class>
+	static std::false_type test(...);
+
+	using type = decltype(test<F>(0));
+};
+
+template <class F, class... Args>
+struct is_callable : is_callable_impl<F, Args...>::type {
+};
+
 } // namespace detail
 } // namespace pl
\ No newline at end of file
@@ -0,0 +1,40 @@
+#pragma once
+#include <cstddef> // size_t
+#include "poly.hpp"
+
+namespace pl {
+
+/// Size, alignment and lifetime functions of a type, derived from Base.
+/// Functions make an object in caller-provided memory, that must have
+/// at least size bytes at an align boundary. The object is returned in a
+/// poly that destroys it without freeing the memory.
+/// Functions, that the type does not support, are nullptr. destroy is
+/// always provided.
+template <class Base>
+struct type_layout {
+	using poly_type = poly<Base, in_place<Base>>;
+
+	std::size_t size;
+	std::size_t align;
+
+	/// Default-constructs the object in memory
+	poly_type (*construct)(void* memory);
+	/// Copy-constructs the object in memory from other, of the same type
+	poly_type (*copy)(void* memory, const Base& other);
+	/// Move-constructs the object in memory from other, of the same type
+	poly_type (*move)(void* memory, Base& other);
+	/// Destroys obj, of the same type, without freeing its memory. For objects,
+	/// released from the poly that made them.
+	void (*destroy)(Base* obj);
+};
+
+namespace detail {
+
+/// Returns the layout of Derived. Every call returns the same object.
+template <class Base, class Derived>
+const type_layout<Base>* layout_of();
+
+} // namespace detail
+} // namespace pl
+
+#include "type_layout.inl"
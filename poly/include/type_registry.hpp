@@ -0,0 +1,68 @@
+#pragma once
+#include <cstddef>       // ptrdiff_t
+#include <typeindex>     // type_index
+#include <typeinfo>      // type_info
+#include "snapshot_map.hpp"
+
+namespace pl {
+namespace detail {
+
+/// Operations on a registered type, on its most derived object
+struct erased_type {
+	void* (*clone)(const void* obj);
+};
+
+/// Provides an erased_type for type T
+template <class T>
+struct erased_model {
+	static const erased_type value;
+};
+
+/// Every type, registered by a policy that uses the registry, whatever the
+/// base it was registered for. Looked up by the address of its type_info,
+/// and by name if another copy of the type_info is used, as may happen for
+/// types from shared libraries.
+snapshot_map<const std::type_info*, const erased_type*>& erased_types();
+snapshot_map<std::type_index, const erased_type*>& erased_names();
+
+/// Returns the registration of type, or nullptr if it was never registered
+const erased_type* find_erased(const std::type_info& type);
+
+/// Registers T. Only the first call for each T takes a lock.
+template <class T>
+void register_type();
+
+/// Operations on a registered dynamic type, through its Base subobject
+template <class Base>
+struct type_entry {
+	const erased_type* type;
+	std::ptrdiff_t offset; // Of the Base subobject from the most derived object
+
+	Base* clone(const Base* obj) const;
+};
+
+/// Maps every dynamic type, adopted by a policy that uses the registry,
+/// to its type_entry. Lookups are lock-free. The entry for a base is made
+/// on the first lookup of an object, from the registration of its dynamic
+/// type, so objects can change their base, as pl::cast does.
+template <class Base>
+class type_registry {
+public:
+	using entry = type_entry<Base>;
+
+	/// Registers Derived. Only the first call for each Derived takes a lock.
+	template <class Derived>
+	static void insert();
+
+	/// Returns the entry for the dynamic type of obj, or nullptr if the type
+	/// was never registered.
+	static const entry* find(const Base* obj);
+
+private:
+	static snapshot_map<const std::type_info*, entry>& entries();
+};
+
+} // namespace detail
+} // namespace pl
+
+#include "type_registry.inl"
@@ -0,0 +1,88 @@
+#pragma once
+#include <cstddef>          // size_t, ptrdiff_t
+#include <initializer_list> // initializer_list
+#include "relocate.hpp"
+
+namespace pl {
+
+/// A vector, that moves its elements with relocate. For trivially
+/// relocatable types, like poly, growth, insertion and erasure move
+/// elements with memmove instead of a move and a destruction per element.
+/// Iterators are pointers, and are invalidated same as for std::vector.
+template <class T>
+class vector {
+public:
+	using value_type = T;
+	using size_type = std::size_t;
+	using difference_type = std::ptrdiff_t;
+	using reference = T&;
+	using const_reference = const T&;
+	using pointer = T*;
+	using const_pointer = const T*;
+	using iterator = T*;
+	using const_iterator = const T*;
+
+	// Construction ============================================================
+	vector() noexcept;
+	vector(std::initializer_list<T> values);
+	vector(const vector& other);
+	vector(vector&& other) noexcept;
+	vector& operator=(const vector& other);
+	vector& operator=(vector&& other) noexcept;
+	~vector();
+
+	// Iterators ===============================================================
+	iterator begin() noexcept;
+	const_iterator begin() const noexcept;
+	iterator end() noexcept;
+	const_iterator end() const noexcept;
+
+	// Capacity ================================================================
+	bool empty() const noexcept;
+	size_type size() const noexcept;
+	size_type capacity() const noexcept;
+	void reserve(size_type new_capacity);
+
+	// Element access ==========================================================
+	T& operator[](size_type i);
+	const T& operator[](size_type i) const;
+	T& front();
+	const T& front() const;
+	T& back();
+	const T& back() const;
+	T* data() noexcept;
+	const T* data() const noexcept;
+
+	// Modifiers ===============================================================
+	void push_back(const T& value);
+	void push_back(T&& value);
+	template <class... Args>
+	T& emplace_back(Args&&... args);
+	void pop_back();
+
+	iterator insert(const_iterator pos, const T& value);
+	iterator insert(const_iterator pos, T&& value);
+	template <class... Args>
+	iterator emplace(const_iterator pos, Args&&... args);
+
+	iterator erase(const_iterator pos);
+	iterator erase(const_iterator first, const_iterator last);
+
+	void clear() noexcept;
+	void swap(vector& other) noexcept;
+
+private:
+	/// Capacity to grow to, when one more element is needed
+	size_type next_capacity() const noexcept;
+
+	static T* allocate(size_type n);
+	static void deallocate(T* ptr) noexcept;
+
+	T* first;
+	T* last;
+	T* storage_end;
+};
+
+} // namespace pl
+
+#include "vector.inl"
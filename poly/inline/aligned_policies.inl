@@ -0,0 +1,128 @@
+#pragma once
+#include <cstdint>     // uintptr_t
+#include <new>         // operator new, placement new
+#include <stdexcept>   // runtime_error
+#include <string>      // string
+#include <type_traits> // has_virtual_destructor, is_copy_constructible
+#include <utility>     // forward
+#include "aligned_policies.hpp"
+#include "inheritance_traits.hpp"
+
+namespace pl {
+namespace detail {
+
+inline void* aligned_allocate(std::size_t size, std::size_t align) {
+	size = (size + align - 1) & ~(align - 1);
+
+	// The pointer, returned by operator new, is stored right before the block
+	void* raw = ::operator new(size + align - 1 + sizeof(void*));
+	std::uintptr_t block = reinterpret_cast<std::uintptr_t>(raw) + sizeof(void*);
+	block = (block + align - 1) & ~static_cast<std::uintptr_t>(align - 1);
+
+	void* rslt = reinterpret_cast<void*>(block);
+	static_cast<void**>(rslt)[-1] = raw;
+	return rslt;
+}
+
+inline void aligned_free(void* ptr) noexcept {
+	if (ptr) ::operator delete(static_cast<void**>(ptr)[-1]);
+}
+
+/// Alignment of Derived, made by a policy with alignment Align
+template <class Derived, std::size_t Align>
+struct aligned_alignment : std::integral_constant<std::size_t,
+	(alignof(Derived) > Align ? alignof(Derived) : Align)> {
+};
+
+/// Makes a Derived in aligned memory and returns it
+template <class Derived, std::size_t Align, class... Args>
+inline Derived* aligned_create(Args&&... args) {
+	void* memory = aligned_allocate(
+		sizeof(Derived), aligned_alignment<Derived, Align>::value);
+	try {
+		return new (memory) Derived(std::forward<Args>(args)...);
+	}
+	catch (...) {
+		aligned_free(memory);
+		throw;
+	}
+}
+
+/// Copies Derived into aligned memory
+template<class Base, class Derived, std::size_t Align>
+inline typename std::enable_if<
+	std::is_copy_constructible<Derived>::value, Base*>::type
+	aligned_clone(const Base* other) {
+	const Derived* temp = inheritance_traits<Base, Derived>::downcast(other);
+	return aligned_create<Derived, Align>(*temp);
+}
+
+/// Placeholder for when Derived is not CopyConstructible. Throws on call.
+template<class Base, class Derived, std::size_t Align>
+inline typename std::enable_if<
+	!std::is_copy_constructible<Derived>::value, Base*>::type
+	aligned_clone(const Base*) {
+	throw std::runtime_error(
+		std::string("poly: poly<") +
+		POLY_TYPE_NAME(Base) +
+		"> is attempting to copy '" +
+		POLY_TYPE_NAME(Derived) +
+		"', which is not copy-constructible");
+}
+
+} // namespace detail
+
+// class aligned_copy ==========================================================
+
+template<class Base, std::size_t Align>
+constexpr aligned_copy<Base, Align>::aligned_copy() noexcept :
+	clone_ptr(nullptr) {
+}
+
+template<class Base, std::size_t Align>
+template<class Base2>
+inline aligned_copy<Base, Align>::
+aligned_copy(const aligned_copy<Base2, Align>& other) noexcept :
+	clone_ptr(other.clone_ptr) {
+}
+
+template<class Base, std::size_t Align>
+template<class Derived>
+inline aligned_copy<Base, Align>::aligned_copy(const Derived*) :
+	clone_ptr(&detail::aligned_clone<Base, Derived, Align>) {
+	static_assert(std::is_base_of<Base, Derived>::value,
+		"aligned_copy: Base is not base of Derived");
+}
+
+template<class Base, std::size_t Align>
+inline Base* aligned_copy<Base, Align>::operator()(const Base* other) {
+	return clone_ptr(other);
+}
+
+// class aligned_delete ========================================================
+
+template<class Base, std::size_t Align>
+template<class Base2>
+inline aligned_delete<Base, Align>::
+aligned_delete(const aligned_delete<Base2, Align>&) noexcept {
+}
+
+template<class Base, std::size_t Align>
+template<class Derived, class... Args>
+inline Derived* aligned_delete<Base, Align>::create(Args&&... args) {
+	return detail::aligned_create<Derived, Align>(std::forward<Args>(args)...);
+}
+
+template<class Base, std::size_t Align>
+inline void aligned_delete<Base, Align>::operator()(const Base* ptr) const {
+	static_assert(std::has_virtual_destructor<Base>::value,
+		"aligned_delete: Base does not have a virtual destructor, a memory leak will occur.");
+	if (!ptr) return;
+
+	// The memory starts at the most derived object
+	void* memory = const_cast<void*>(dynamic_cast<const void*>(ptr));
+	ptr->~Base();
+	detail::aligned_free(memory);
+}
+
+} // namespace pl
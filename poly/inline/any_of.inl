@@ -0,0 +1,274 @@
+#pragma once
+#include <new>       // placement new
+#include <stdexcept> // runtime_error
+#include <string>    // string
+#include <utility>   // forward, move
+#include "any_of.hpp"
+
+namespace pl {
+
+template <std::size_t Size, std::size_t Align>
+constexpr std::size_t inline_storage<Size, Align>::size;
+
+template <std::size_t Size, std::size_t Align>
+constexpr std::size_t inline_storage<Size, Align>::align;
+
+namespace detail {
+
+// struct any_slots ============================================================
+
+template <class... Methods>
+constexpr any_slots<Methods...>::any_slots(typename Methods::thunk_type... thunks) :
+	any_slot<Methods>{thunks}... {
+}
+
+// struct any_table ============================================================
+
+template <class... Methods>
+constexpr any_table<Methods...>::any_table(const std::type_info& type,
+	void (*destroy)(void*),
+	void* (*copy)(const void*, void*),
+	void* (*move)(void*, void*),
+	typename Methods::thunk_type... thunks) :
+	type(&type),
+	destroy(destroy),
+	copy(copy),
+	move(move),
+	methods(thunks...) {
+}
+
+// struct any_model ============================================================
+
+template <class T, bool Local, class... Methods>
+struct any_model<any_table<Methods...>, T, Local> {
+	using local = std::integral_constant<bool, Local>;
+	using copyable = std::is_copy_constructible<T>;
+
+	static void destroy(void* obj) {
+		destroy(static_cast<T*>(obj), local());
+	}
+
+	static void* copy(const void* obj, void* buffer) {
+		return copy(static_cast<const T*>(obj), buffer, local(), copyable());
+	}
+
+	static void* move(void* obj, void* buffer) {
+		return move(static_cast<T*>(obj), buffer, local());
+	}
+
+	static const any_table<Methods...> value;
+
+private:
+	static void destroy(T* obj, std::true_type) {
+		obj->~T();
+	}
+
+	static void destroy(T* obj, std::false_type) {
+		delete obj;
+	}
+
+	static void* copy(const T* obj, void* buffer, std::true_type, std::true_type) {
+		return new (buffer) T(*obj);
+	}
+
+	static void* copy(const T* obj, void*, std::false_type, std::true_type) {
+		return new T(*obj);
+	}
+
+	template <class L>
+	static void* copy(const T*, void*, L, std::false_type) {
+		throw std::runtime_error(
+			std::string("any_of: attempting to copy '") +
+			POLY_TYPE_NAME(T) +
+			"', which is not copy-constructible");
+	}
+
+	static void* move(T* obj, void* buffer, std::true_type) {
+		T* rslt = new (buffer) T(std::move(*obj));
+		obj->~T();
+		return rslt;
+	}
+
+	static void* move(T* obj, void*, std::false_type) {
+		return obj;
+	}
+};
+
+template <class T, bool Local, class... Methods>
+const any_table<Methods...> any_model<any_table<Methods...>, T, Local>::value(
+	typeid(T),
+	&any_model::destroy,
+	&any_model::copy,
+	&any_model::move,
+	&method_thunk<Methods, T, typename Methods::thunk_type>::invoke...);
+
+} // namespace detail
+
+// class any_of ================================================================
+// Construction ================================================================
+
+template <class... Methods, std::size_t Size, std::size_t Align>
+inline any_of<type_list<Methods...>, inline_storage<Size, Align>>::
+any_of() noexcept :
+	vtable(nullptr),
+	object(nullptr) {
+}
+
+template <class... Methods, std::size_t Size, std::size_t Align>
+inline any_of<type_list<Methods...>, inline_storage<Size, Align>>::
+any_of(const any_of& other) :
+	vtable(other.vtable),
+	object(other.vtable ? other.vtable->copy(other.object, buffer) : nullptr) {
+}
+
+template <class... Methods, std::size_t Size, std::size_t Align>
+inline any_of<type_list<Methods...>, inline_storage<Size, Align>>::
+any_of(any_of&& other) noexcept :
+	vtable(other.vtable),
+	object(other.vtable ? other.vtable->move(other.object, buffer) : nullptr) {
+	other.vtable = nullptr;
+	other.object = nullptr;
+}
+
+template <class... Methods, std::size_t Size, std::size_t Align>
+inline any_of<type_list<Methods...>, inline_storage<Size, Align>>&
+any_of<type_list<Methods...>, inline_storage<Size, Align>>::
+operator=(const any_of& other) {
+	any_of temp(other);
+	return *this = std::move(temp);
+}
+
+template <class... Methods, std::size_t Size, std::size_t Align>
+inline any_of<type_list<Methods...>, inline_storage<Size, Align>>&
+any_of<type_list<Methods...>, inline_storage<Size, Align>>::
+operator=(any_of&& other) noexcept {
+	if (this != &other) {
+		reset();
+		vtable = other.vtable;
+		object = other.vtable ? other.vtable->move(other.object, buffer) : nullptr;
+		other.vtable = nullptr;
+		other.object = nullptr;
+	}
+
+	return *this;
+}
+
+template <class... Methods, std::size_t Size, std::size_t Align>
+template <class T, class>
+inline any_of<type_list<Methods...>, inline_storage<Size, Align>>::
+any_of(T&& value) :
+	vtable(nullptr),
+	object(nullptr) {
+	emplace<typename std::decay<T>::type>(std::forward<T>(value));
+}
+
+template <class... Methods, std::size_t Size, std::size_t Align>
+inline any_of<type_list<Methods...>, inline_storage<Size, Align>>::~any_of() {
+	reset();
+}
+
+// Observers ===================================================================
+
+template <class... Methods, std::size_t Size, std::size_t Align>
+template <class T>
+inline bool any_of<type_list<Methods...>, inline_storage<Size, Align>>::
+is() const noexcept {
+	// The table of T is not used, as it fails to compile for types, that
+	// don't implement the methods
+	return vtable != nullptr && *vtable->type == typeid(T);
+}
+
+template <class... Methods, std::size_t Size, std::size_t Align>
+inline const std::type_info&
+any_of<type_list<Methods...>, inline_storage<Size, Align>>::type() const noexcept {
+	return vtable ? *vtable->type : typeid(void);
+}
+
+template <class... Methods, std::size_t Size, std::size_t Align>
+inline any_of<type_list<Methods...>, inline_storage<Size, Align>>::
+operator bool() const noexcept {
+	return vtable != nullptr;
+}
+
+// Modifiers ===================================================================
+
+template <class... Methods, std::size_t Size, std::size_t Align>
+template <class T, class... Args>
+inline T& any_of<type_list<Methods...>, inline_storage<Size, Align>>::
+emplace(Args&&... args) {
+	reset();
+	object = create<T>(is_local<T>(), std::forward<Args>(args)...);
+	vtable = &model<T>::value;
+
+	return *static_cast<T*>(object);
+}
+
+template <class... Methods, std::size_t Size, std::size_t Align>
+inline void any_of<type_list<Methods...>, inline_storage<Size, Align>>::
+reset() noexcept {
+	if (vtable) {
+		vtable->destroy(object);
+		vtable = nullptr;
+		object = nullptr;
+	}
+}
+
+template <class... Methods, std::size_t Size, std::size_t Align>
+template <class T, class... Args>
+inline void* any_of<type_list<Methods...>, inline_storage<Size, Align>>::
+create(std::true_type, Args&&... args) {
+	return new (buffer) T(std::forward<Args>(args)...);
+}
+
+template <class... Methods, std::size_t Size, std::size_t Align>
+template <class T, class... Args>
+inline void* any_of<type_list<Methods...>, inline_storage<Size, Align>>::
+create(std::false_type, Args&&... args) {
+	return new T(std::forward<Args>(args)...);
+}
+
+// Member access ===============================================================
+
+template <class... Methods, std::size_t Size, std::size_t Align>
+template <class T>
+inline T* any_of<type_list<Methods...>, inline_storage<Size, Align>>::
+as() noexcept {
+	return is<T>() ? static_cast<T*>(object) : nullptr;
+}
+
+template <class... Methods, std::size_t Size, std::size_t Align>
+template <class T>
+inline const T* any_of<type_list<Methods...>, inline_storage<Size, Align>>::
+as() const noexcept {
+	return is<T>() ? static_cast<const T*>(object) : nullptr;
+}
+
+template <class... Methods, std::size_t Size, std::size_t Align>
+template <class Method, class... Args>
+inline typename Method::result_type
+any_of<type_list<Methods...>, inline_storage<Size, Align>>::
+call(Args&&... args) {
+	static_assert(std::is_base_of<
+		detail::any_slot<Method>, detail::any_slots<Methods...>>::value,
+		"any_of: method is not a part of the interface");
+
+	return static_cast<const detail::any_slot<Method>&>(vtable->methods).
+		thunk(object, std::forward<Args>(args)...);
+}
+
+template <class... Methods, std::size_t Size, std::size_t Align>
+template <class Method, class... Args>
+inline typename Method::result_type
+any_of<type_list<Methods...>, inline_storage<Size, Align>>::
+call(Args&&... args) const {
+	static_assert(std::is_base_of<
+		detail::any_slot<Method>, detail::any_slots<Methods...>>::value,
+		"any_of: method is not a part of the interface");
+	static_assert(Method::is_const,
+		"any_of: cannot call a non-const method on a const any_of");
+
+	return static_cast<const detail::any_slot<Method>&>(vtable->methods).
+		thunk(object, std::forward<Args>(args)...);
+}
+
+} // namespace pl
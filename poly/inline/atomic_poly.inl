@@ -0,0 +1,104 @@
+#pragma once
+#include <utility> // move
+#include "atomic_poly.hpp"
+
+namespace pl {
+
+// class atomic_poly::read_handle ==============================================
+
+template<class Base, class CopyDeletePolicy>
+inline atomic_poly<Base, CopyDeletePolicy>::read_handle::
+read_handle(const poly_type* node) noexcept :
+	node(node) {
+}
+
+template<class Base, class CopyDeletePolicy>
+inline Base& atomic_poly<Base, CopyDeletePolicy>::read_handle::operator*() const {
+	return **node;
+}
+
+template<class Base, class CopyDeletePolicy>
+inline Base* atomic_poly<Base, CopyDeletePolicy>::read_handle::operator->() const noexcept {
+	return get();
+}
+
+template<class Base, class CopyDeletePolicy>
+inline Base* atomic_poly<Base, CopyDeletePolicy>::read_handle::get() const noexcept {
+	return node ? node->get() : nullptr;
+}
+
+template<class Base, class CopyDeletePolicy>
+inline atomic_poly<Base, CopyDeletePolicy>::read_handle::operator bool() const noexcept {
+	return get() != nullptr;
+}
+
+// class atomic_poly ===========================================================
+// Every object is held in a heap-allocated poly, so that the pointer and
+// the policy's state are replaced together with a single atomic exchange.
+
+template<class Base, class CopyDeletePolicy>
+inline atomic_poly<Base, CopyDeletePolicy>::atomic_poly() noexcept :
+	data(nullptr) {
+}
+
+template<class Base, class CopyDeletePolicy>
+inline atomic_poly<Base, CopyDeletePolicy>::atomic_poly(poly_type value) :
+	data(new poly_type(std::move(value))) {
+}
+
+template<class Base, class CopyDeletePolicy>
+inline atomic_poly<Base, CopyDeletePolicy>::~atomic_poly() {
+	delete data.load(std::memory_order_acquire);
+}
+
+template<class Base, class CopyDeletePolicy>
+inline typename atomic_poly<Base, CopyDeletePolicy>::read_handle
+atomic_poly<Base, CopyDeletePolicy>::load() const {
+	// The guard is entered in the handle before data is read
+	read_handle rslt(nullptr);
+	rslt.node = data.load(std::memory_order_seq_cst);
+	return rslt;
+}
+
+template<class Base, class CopyDeletePolicy>
+inline void atomic_poly<Base, CopyDeletePolicy>::store(poly_type value) {
+	poly_type* old = data.exchange(new poly_type(std::move(value)), std::memory_order_seq_cst);
+	if (old) detail::epoch_domain::instance().retire(old, &destroy_node);
+}
+
+template<class Base, class CopyDeletePolicy>
+inline typename atomic_poly<Base, CopyDeletePolicy>::poly_type
+atomic_poly<Base, CopyDeletePolicy>::exchange(poly_type value) {
+	poly_type* old = data.exchange(new poly_type(std::move(value)), std::memory_order_seq_cst);
+	if (!old) return poly_type();
+
+	detail::epoch_domain::instance().synchronize();
+
+	poly_type rslt(std::move(*old));
+	delete old;
+	return rslt;
+}
+
+template<class Base, class CopyDeletePolicy>
+inline bool atomic_poly<Base, CopyDeletePolicy>::
+compare_exchange(const read_handle& expected, poly_type& desired) {
+	// expected's guard keeps its node alive, so the node can't be reused
+	poly_type* old = const_cast<poly_type*>(expected.node);
+	poly_type* next = new poly_type(std::move(desired));
+
+	if (data.compare_exchange_strong(old, next, std::memory_order_seq_cst)) {
+		if (old) detail::epoch_domain::instance().retire(old, &destroy_node);
+		return true;
+	}
+
+	desired = std::move(*next);
+	delete next;
+	return false;
+}
+
+template<class Base, class CopyDeletePolicy>
+inline void atomic_poly<Base, CopyDeletePolicy>::destroy_node(void* node) {
+	delete static_cast<poly_type*>(node);
+}
+
+} // namespace pl
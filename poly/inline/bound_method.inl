@@ -0,0 +1,84 @@
+#pragma once
+#include <stdexcept> // invalid_argument
+#include <string>    // string
+#include <typeinfo>  // typeid
+#include <type_traits> // is_base_of, is_const
+#include <utility>   // forward
+#include "bound_method.hpp"
+#include "inheritance_traits.hpp"
+
+namespace pl {
+namespace detail {
+
+// Finds the type of ptr's object in the list and returns the object as void*,
+// with the thunk for its type. Returns nullptr if the type is not found.
+template <class Method, class Base>
+inline void* bind_target(Base*, typename Method::thunk_type&, type_list<>) {
+	return nullptr;
+}
+
+template <class Method, class Base, class T, class... Ts>
+inline void* bind_target(Base* ptr,
+	typename Method::thunk_type& thunk, type_list<T, Ts...>) {
+	static_assert(std::is_base_of<Base, T>::value,
+		"bound: listed type is not derived from Base");
+
+	if (typeid(*ptr) == typeid(T)) {
+		thunk = &method_thunk<Method, T, typename Method::thunk_type>::invoke;
+		return const_cast<void*>(static_cast<const void*>(
+			inheritance_traits<Base, T>::downcast(ptr)));
+	}
+	return bind_target<Method>(ptr, thunk, type_list<Ts...>());
+}
+
+} // namespace detail
+
+// class bound_method ==========================================================
+
+template<class Method>
+constexpr bound_method<Method>::bound_method() noexcept :
+	object(nullptr),
+	thunk(nullptr) {
+}
+
+template<class Method>
+inline bound_method<Method>::
+bound_method(void* object, typename Method::thunk_type thunk) noexcept :
+	object(object),
+	thunk(thunk) {
+}
+
+template<class Method>
+template<class... Args>
+inline typename bound_method<Method>::result_type
+bound_method<Method>::operator()(Args&&... args) const {
+	return thunk(object, std::forward<Args>(args)...);
+}
+
+template<class Method>
+constexpr bound_method<Method>::operator bool() const noexcept {
+	return thunk != nullptr;
+}
+
+// Non-member functions ========================================================
+
+template<class Method, class List, class Base, class CopyDeletePolicy>
+bound_method<Method> bound(const poly<Base, CopyDeletePolicy>& p) {
+	static_assert(!std::is_const<Base>::value || Method::is_const,
+		"bound: cannot bind a non-const method to a const object");
+
+	if (!p) throw std::invalid_argument("bound: poly is empty");
+
+	typename Method::thunk_type thunk = nullptr;
+	void* object = detail::bind_target<Method>(p.get(), thunk, List());
+	if (!object) {
+		throw std::invalid_argument(
+			std::string("bound: type '") +
+			typeid(*p).name() +
+			"' is not in the list");
+	}
+
+	return bound_method<Method>(object, thunk);
+}
+
+} // namespace pl
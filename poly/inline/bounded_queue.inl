@@ -0,0 +1,252 @@
+#pragma once
+#include <utility> // move
+#include "bounded_queue.hpp"
+
+namespace pl {
+namespace detail {
+
+template<class T>
+inline bounded_queue<T>::bounded_queue(std::size_t capacity) :
+	mask(0),
+	enqueue_pos(0),
+	dequeue_pos(0) {
+	std::size_t size = 2;
+	while (size < capacity) size *= 2;
+
+	cells.reset(new cell[size]);
+	mask = size - 1;
+	for (std::size_t i = 0; i < size; ++i) {
+		cells[i].sequence.store(i, std::memory_order_relaxed);
+	}
+}
+
+template<class T>
+inline bool bounded_queue<T>::try_push(T& value) noexcept {
+	std::size_t pos = enqueue_pos.load(std::memory_order_relaxed);
+
+	while (true) {
+		cell& c = cells[pos & mask];
+		std::size_t seq = c.sequence.load(std::memory_order_acquire);
+		auto diff = static_cast<std::ptrdiff_t>(seq) - static_cast<std::ptrdiff_t>(pos);
+
+		if (diff == 0) {
+			// Cell is free in this lap, try to claim it
+			if (enqueue_pos.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) {
+				c.value = std::move(value);
+				c.sequence.store(pos + 1, std::memory_order_release);
+				return true;
+			}
+		}
+		else if (diff < 0) {
+			// Cell still holds a value from the previous lap
+			return false;
+		}
+		else {
+			pos = enqueue_pos.load(std::memory_order_relaxed);
+		}
+	}
+}
+
+template<class T>
+inline bool bounded_queue<T>::try_pop(T& value) noexcept {
+	std::size_t pos;
+	if (!lock_front(pos)) return false;
+
+	value = std::move(cells[pos & mask].value);
+	pop_front(pos, 1);
+	return true;
+}
+
+template<class T>
+template<class It>
+inline It bounded_queue<T>::try_push(It first, It last) noexcept {
+	std::size_t pos = enqueue_pos.load(std::memory_order_relaxed);
+	std::size_t n;
+
+	while (true) {
+		// Count free cells from pos. Only producers fill free cells, and only
+		// after claiming them, so they stay free if the claim succeeds.
+		n = 0;
+		std::size_t seq = pos;
+		for (It it = first; it != last; ++it, ++n) {
+			seq = cells[(pos + n) & mask].sequence.load(std::memory_order_acquire);
+			if (seq != pos + n) break;
+		}
+
+		if (n != 0) {
+			if (enqueue_pos.compare_exchange_weak(pos, pos + n, std::memory_order_relaxed)) break;
+		}
+		else if (first == last || static_cast<std::ptrdiff_t>(seq) - static_cast<std::ptrdiff_t>(pos) < 0) {
+			// Cell still holds a value from the previous lap
+			return first;
+		}
+		else {
+			pos = enqueue_pos.load(std::memory_order_relaxed);
+		}
+	}
+
+	for (std::size_t i = 0; i < n; ++i, ++first) {
+		cell& c = cells[(pos + i) & mask];
+		c.value = std::move(*first);
+		c.sequence.store(pos + i + 1, std::memory_order_release);
+	}
+	return first;
+}
+
+template<class T>
+template<class OutputIt>
+inline std::size_t bounded_queue<T>::try_pop(OutputIt out, std::size_t max) {
+	std::size_t pos;
+	if (max == 0 || !lock_front(pos)) return 0;
+
+	// No other consumer gets past the locked cell, so cells after it are read
+	// without claiming them. If out throws, values that were already moved
+	// out are popped.
+	std::size_t n = 0;
+	try {
+		do {
+			*out++ = std::move(cells[(pos + n) & mask].value);
+			++n;
+		} while (n < max &&
+			cells[(pos + n) & mask].sequence.load(std::memory_order_acquire) == pos + n + 1);
+	}
+	catch (...) {
+		pop_front(pos, n);
+		throw;
+	}
+
+	pop_front(pos, n);
+	return n;
+}
+
+template<class T>
+inline bool bounded_queue<T>::lock_front(std::size_t& pos) noexcept {
+	pos = dequeue_pos.load(std::memory_order_relaxed);
+
+	while (true) {
+		cell& c = cells[pos & mask];
+		std::size_t seq = c.sequence.load(std::memory_order_acquire);
+		auto diff = static_cast<std::ptrdiff_t>(seq) - static_cast<std::ptrdiff_t>(pos + 1);
+
+		if (diff == 0) {
+			// Cell holds a value in this lap, try to lock it. A locked cell
+			// looks empty to consumers, and full to producers.
+			if (c.sequence.compare_exchange_weak(seq, pos, std::memory_order_acquire,
+				std::memory_order_relaxed)) {
+				return true;
+			}
+		}
+		else if (diff < 0) {
+			// Cell was not written in this lap yet, or is locked
+			return false;
+		}
+		pos = dequeue_pos.load(std::memory_order_relaxed);
+	}
+}
+
+template<class T>
+inline void bounded_queue<T>::pop_front(std::size_t pos, std::size_t n) noexcept {
+	if (n == 0) {
+		cells[pos & mask].sequence.store(pos + 1, std::memory_order_release);
+		return;
+	}
+
+	// Only the holder of the lock moves dequeue_pos
+	dequeue_pos.store(pos + n, std::memory_order_relaxed);
+	for (std::size_t i = 0; i < n; ++i) {
+		cells[(pos + i) & mask].sequence.store(pos + i + mask + 1, std::memory_order_release);
+	}
+}
+
+template<class T>
+inline std::size_t bounded_queue<T>::capacity() const noexcept {
+	return mask + 1;
+}
+
+// spsc_queue ==================================================================
+
+template<class T>
+inline spsc_queue<T>::spsc_queue(std::size_t capacity) :
+	mask(0),
+	head(0),
+	cached_tail(0),
+	tail(0),
+	cached_head(0) {
+	std::size_t size = 2;
+	while (size < capacity) size *= 2;
+
+	cells.reset(new T[size]);
+	mask = size - 1;
+}
+
+template<class T>
+inline bool spsc_queue<T>::try_push(T& value) noexcept {
+	std::size_t pos = tail.load(std::memory_order_relaxed);
+	if (pos - cached_head > mask) {
+		cached_head = head.load(std::memory_order_acquire);
+		if (pos - cached_head > mask) return false;
+	}
+
+	cells[pos & mask] = std::move(value);
+	tail.store(pos + 1, std::memory_order_release);
+	return true;
+}
+
+template<class T>
+inline bool spsc_queue<T>::try_pop(T& value) noexcept {
+	std::size_t pos = head.load(std::memory_order_relaxed);
+	if (pos == cached_tail) {
+		cached_tail = tail.load(std::memory_order_acquire);
+		if (pos == cached_tail) return false;
+	}
+
+	value = std::move(cells[pos & mask]);
+	head.store(pos + 1, std::memory_order_release);
+	return true;
+}
+
+template<class T>
+template<class It>
+inline It spsc_queue<T>::try_push(It first, It last) noexcept {
+	std::size_t pos = tail.load(std::memory_order_relaxed);
+	std::size_t end = pos;
+	for (; first != last; ++first, ++end) {
+		if (end - cached_head > mask) {
+			cached_head = head.load(std::memory_order_acquire);
+			if (end - cached_head > mask) break;
+		}
+		cells[end & mask] = std::move(*first);
+	}
+
+	if (end != pos) tail.store(end, std::memory_order_release);
+	return first;
+}
+
+template<class T>
+template<class OutputIt>
+inline std::size_t spsc_queue<T>::try_pop(OutputIt out, std::size_t max) {
+	std::size_t pos = head.load(std::memory_order_relaxed);
+	if (cached_tail - pos < max) cached_tail = tail.load(std::memory_order_acquire);
+	std::size_t n = cached_tail - pos < max ? cached_tail - pos : max;
+
+	// If out throws, values that were already moved out are popped
+	std::size_t i = 0;
+	try {
+		for (; i < n; ++i) *out++ = std::move(cells[(pos + i) & mask]);
+	}
+	catch (...) {
+		head.store(pos + i, std::memory_order_release);
+		throw;
+	}
+
+	if (n != 0) head.store(pos + n, std::memory_order_release);
+	return n;
+}
+
+template<class T>
+inline std::size_t spsc_queue<T>::capacity() const noexcept {
+	return mask + 1;
+}
+
+} // namespace detail
+} // namespace pl
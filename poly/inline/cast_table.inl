@@ -0,0 +1,49 @@
+#pragma once
+#include "cast_table.hpp"
+
+namespace pl {
+namespace detail {
+
+template<class Base, class Target>
+constexpr std::ptrdiff_t cast_table<Base, Target>::none;
+
+template<class Base, class Target>
+inline snapshot_map<const std::type_info*, std::ptrdiff_t>&
+cast_table<Base, Target>::offsets() {
+	static snapshot_map<const std::type_info*, std::ptrdiff_t> rslt;
+	return rslt;
+}
+
+template<class Base, class Target>
+inline std::ptrdiff_t cast_table<Base, Target>::offset(const Base* ptr) {
+	const std::type_info* type = &typeid(*ptr);
+
+	const std::ptrdiff_t* known = offsets().find(type);
+	if (known) return *known;
+
+	const Target* target = dynamic_cast<const Target*>(ptr);
+	std::ptrdiff_t rslt = target == nullptr ? none :
+		reinterpret_cast<const unsigned char*>(target) -
+		reinterpret_cast<const unsigned char*>(ptr);
+
+	return offsets().insert(type, rslt);
+}
+
+template<class Base, class Target>
+inline Target* cast_table<Base, Target>::cast(Base* ptr) {
+	return const_cast<Target*>(cast(static_cast<const Base*>(ptr)));
+}
+
+template<class Base, class Target>
+inline const Target* cast_table<Base, Target>::cast(const Base* ptr) {
+	if (ptr == nullptr) return nullptr;
+
+	std::ptrdiff_t off = offset(ptr);
+	if (off == none) return nullptr;
+
+	return reinterpret_cast<const Target*>(
+		reinterpret_cast<const unsigned char*>(ptr) + off);
+}
+
+} // namespace detail
+} // namespace pl
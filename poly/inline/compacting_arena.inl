@@ -0,0 +1,353 @@
+#pragma once
+#include <algorithm>   // max, sort
+#include <new>         // placement new
+#include <stdexcept>   // runtime_error
+#include <string>      // string
+#include <type_traits> // is_base_of, is_copy_constructible
+#include <utility>     // forward, move
+#include "compacting_arena.hpp"
+#include "aligned_policies.hpp"
+#include "inheritance_traits.hpp"
+
+namespace pl {
+namespace detail {
+
+// arena_model =================================================================
+
+template <class T>
+inline void arena_destroy(void* obj) {
+	static_cast<T*>(obj)->~T();
+}
+
+template <class T>
+inline void arena_relocate(void* from, void* to) {
+	T* source = static_cast<T*>(from);
+	new (to) T(std::move(*source));
+	source->~T();
+}
+
+template <class T>
+inline typename std::enable_if<std::is_copy_constructible<T>::value>::type
+arena_copy(const void* from, void* to) {
+	new (to) T(*static_cast<const T*>(from));
+}
+
+/// Placeholder for when T is not CopyConstructible. Throws on call.
+template <class T>
+inline typename std::enable_if<!std::is_copy_constructible<T>::value>::type
+arena_copy(const void*, void*) {
+	throw std::runtime_error(
+		std::string("compacting_arena: attempting to copy '") +
+		POLY_TYPE_NAME(T) +
+		"', which is not copy-constructible");
+}
+
+template <class T>
+const arena_type arena_model<T>::value = {
+	sizeof(T),
+	&arena_destroy<T>,
+	&arena_relocate<T>,
+	&arena_copy<T>
+};
+
+} // namespace detail
+
+// class compacting_arena ======================================================
+
+template <class Base>
+constexpr std::size_t compacting_arena<Base>::max_align;
+
+template <class Base>
+inline compacting_arena<Base>::compacting_arena(std::size_t block_size, double threshold) :
+	block_size(block_size),
+	threshold(threshold),
+	current(nullptr),
+	capacity_bytes(0),
+	live_bytes(0) {
+}
+
+template <class Base>
+inline compacting_arena<Base>::~compacting_arena() {
+	for (auto& b : blocks) detail::aligned_free(b->memory);
+}
+
+// Compaction ==================================================================
+
+template <class Base>
+inline bool compacting_arena<Base>::compact(std::chrono::nanoseconds budget) {
+	using clock = std::chrono::steady_clock;
+	const auto start = clock::now();
+	std::lock_guard<std::mutex> lock(mutex);
+
+	// Objects are moved to the current block, which is never a source
+	std::vector<block*> sources;
+	for (auto& b : blocks) {
+		if (b.get() != current && b->live < threshold * b->size) sources.push_back(b.get());
+	}
+	std::sort(sources.begin(), sources.end(),
+		[](const block* x, const block* y) { return x->live < y->live; });
+
+	std::size_t moved = 0;
+	for (block* b : sources) {
+		for (std::size_t pos = 0; pos < b->top;) {
+			header* from = reinterpret_cast<header*>(b->memory + pos);
+			pos += from->size;
+			if (!is_movable(from)) continue;
+
+			// The clock is read every few objects, as it's slower than a move
+			if (moved++ % 8 == 0 && clock::now() - start >= budget) return false;
+
+			header* to = allocate(from->size);
+			try {
+				from->type->relocate(object_of(from), object_of(to));
+			}
+			catch (...) {
+				release(to);
+				throw;
+			}
+			to->type = from->type;
+			to->owner = from->owner;
+			*to->owner = reinterpret_cast<Base*>(object_of(to) +
+				(reinterpret_cast<unsigned char*>(*from->owner) - object_of(from)));
+
+			// Releasing the last object frees the block
+			bool last = b->live == from->size;
+			release(from);
+			if (last) break;
+		}
+	}
+
+	return true;
+}
+
+// Statistics ==================================================================
+
+template <class Base>
+inline std::size_t compacting_arena<Base>::block_count() const {
+	std::lock_guard<std::mutex> lock(mutex);
+	return blocks.size();
+}
+
+template <class Base>
+inline std::size_t compacting_arena<Base>::capacity() const {
+	std::lock_guard<std::mutex> lock(mutex);
+	return capacity_bytes;
+}
+
+template <class Base>
+inline std::size_t compacting_arena<Base>::live() const {
+	std::lock_guard<std::mutex> lock(mutex);
+	return live_bytes;
+}
+
+// Objects =====================================================================
+
+template <class Base>
+template <class T, class... Args>
+inline T* compacting_arena<Base>::create(Args&&... args) {
+	static_assert(std::is_base_of<Base, T>::value,
+		"compacting_arena: objects must be derived from Base");
+	static_assert(alignof(T) <= max_align,
+		"compacting_arena: objects can't be aligned stronger than max_align");
+
+	header* h;
+	{
+		std::lock_guard<std::mutex> lock(mutex);
+		h = allocate(footprint<T>());
+	}
+
+	// Constructors may make other objects in the arena, so they run unlocked
+	try {
+		T* rslt = new (object_of(h)) T(std::forward<Args>(args)...);
+		h->type = &detail::arena_model<T>::value;
+		return rslt;
+	}
+	catch (...) {
+		std::lock_guard<std::mutex> lock(mutex);
+		release(h);
+		throw;
+	}
+}
+
+template <class Base>
+inline Base* compacting_arena<Base>::copy(const Base* obj) {
+	header* source = header_of(obj);
+	header* h;
+	{
+		std::lock_guard<std::mutex> lock(mutex);
+		h = allocate(source->size);
+	}
+
+	try {
+		source->type->copy(object_of(source), object_of(h));
+		h->type = source->type;
+	}
+	catch (...) {
+		std::lock_guard<std::mutex> lock(mutex);
+		release(h);
+		throw;
+	}
+
+	// Base is at the same offset in both objects
+	return reinterpret_cast<Base*>(object_of(h) +
+		(reinterpret_cast<const unsigned char*>(obj) - object_of(source)));
+}
+
+template <class Base>
+inline void compacting_arena<Base>::destroy(const Base* obj) noexcept {
+	header* h = header_of(obj);
+
+	// Destructors may destroy other objects in the arena, so they run unlocked
+	h->type->destroy(object_of(h));
+
+	std::lock_guard<std::mutex> lock(mutex);
+	release(h);
+}
+
+template <class Base>
+template <class B>
+inline void compacting_arena<Base>::adopt(B*& data) noexcept {
+	if (data) header_of(data)->owner = const_cast<Base**>(&data);
+}
+
+template <class Base>
+inline void compacting_arena<Base>::forget(const Base* obj) noexcept {
+	if (obj) header_of(obj)->owner = nullptr;
+}
+
+// Private functions ===========================================================
+
+template <class Base>
+template <class T>
+inline std::size_t compacting_arena<Base>::footprint() noexcept {
+	return sizeof(header) + (sizeof(T) + alignof(header) - 1) / alignof(header) * alignof(header);
+}
+
+template <class Base>
+inline typename compacting_arena<Base>::header*
+compacting_arena<Base>::header_of(const Base* obj) noexcept {
+	const void* most_derived = dynamic_cast<const void*>(obj);
+	return reinterpret_cast<header*>(
+		const_cast<unsigned char*>(static_cast<const unsigned char*>(most_derived))) - 1;
+}
+
+template <class Base>
+inline unsigned char* compacting_arena<Base>::object_of(header* h) noexcept {
+	return reinterpret_cast<unsigned char*>(h + 1);
+}
+
+template <class Base>
+inline bool compacting_arena<Base>::is_movable(header* h) noexcept {
+	if (!h->type || !h->owner) return false;
+
+	// The poly must still point into the object
+	const unsigned char* base = reinterpret_cast<const unsigned char*>(*h->owner);
+	return base >= object_of(h) && base < object_of(h) + h->type->size;
+}
+
+template <class Base>
+inline typename compacting_arena<Base>::header*
+compacting_arena<Base>::allocate(std::size_t size) {
+	if (!current || current->size - current->top < size) {
+		std::size_t new_size = std::max(size, block_size);
+		unsigned char* memory = static_cast<unsigned char*>(
+			detail::aligned_allocate(new_size, max_align));
+		try {
+			std::unique_ptr<block> b(new block{memory, new_size, 0, 0, blocks.size()});
+			blocks.push_back(std::move(b));
+		}
+		catch (...) {
+			detail::aligned_free(memory);
+			throw;
+		}
+		capacity_bytes += new_size;
+
+		block* old = current;
+		current = blocks.back().get();
+		if (old && old->live == 0) free_block(old);
+	}
+
+	header* rslt = reinterpret_cast<header*>(current->memory + current->top);
+	rslt->type = nullptr;
+	rslt->owner = nullptr;
+	rslt->home = current;
+	rslt->size = size;
+
+	current->top += size;
+	current->live += size;
+	live_bytes += size;
+	return rslt;
+}
+
+template <class Base>
+inline void compacting_arena<Base>::release(header* h) noexcept {
+	block* b = h->home;
+	h->type = nullptr;
+	b->live -= h->size;
+	live_bytes -= h->size;
+
+	if (b->live == 0) {
+		if (b == current) b->top = 0;
+		else free_block(b);
+	}
+}
+
+template <class Base>
+inline void compacting_arena<Base>::free_block(block* b) noexcept {
+	std::size_t i = b->index;
+	capacity_bytes -= b->size;
+	detail::aligned_free(b->memory);
+
+	blocks[i] = std::move(blocks.back());
+	blocks[i]->index = i;
+	blocks.pop_back();
+}
+
+template <class Base>
+inline compacting_arena<Base>& default_arena() {
+	static compacting_arena<Base>* arena = new compacting_arena<Base>();
+	return *arena;
+}
+
+// class arena_copy ============================================================
+
+template <class Base>
+template <class Base2>
+inline arena_copy<Base>::arena_copy(const arena_copy<Base2>&) noexcept {
+}
+
+template <class Base>
+inline Base* arena_copy<Base>::operator()(const Base* other) const {
+	return default_arena<typename std::remove_const<Base>::type>().copy(other);
+}
+
+// class arena_delete ==========================================================
+
+template <class Base>
+template <class Base2>
+inline arena_delete<Base>::arena_delete(const arena_delete<Base2>&) noexcept {
+}
+
+template <class Base>
+template <class Derived, class... Args>
+inline Derived* arena_delete<Base>::create(Args&&... args) {
+	return default_arena<typename std::remove_const<Base>::type>().
+		template create<Derived>(std::forward<Args>(args)...);
+}
+
+template <class Base>
+inline void arena_delete<Base>::operator()(const Base* ptr) const {
+	default_arena<typename std::remove_const<Base>::type>().destroy(ptr);
+}
+
+template <class Base>
+inline void arena_delete<Base>::adopt(Base*& data) const noexcept {
+	arena_type::adopt(data);
+}
+
+template <class Base>
+inline void arena_delete<Base>::forget(const Base* data) const noexcept {
+	arena_type::forget(data);
+}
+
+} // namespace pl
@@ -40,6 +40,27 @@ inline void compound<Cloner, Deleter>::destroy(T* ptr) {
 	Deleter::operator()(ptr);
 }
 
+template<class Cloner, class Deleter>
+template<class T, class D, class... Args>
+inline auto compound<Cloner, Deleter>::create(Args&&... args)
+->decltype(D::template create<T>(std::forward<Args>(args)...)) {
+	return D::template create<T>(std::forward<Args>(args)...);
+}
+
+template<class Cloner, class Deleter>
+template<class T, class D>
+inline auto compound<Cloner, Deleter>::adopt(T*& data) noexcept
+->decltype(std::declval<const D&>().adopt(data)) {
+	return Deleter::adopt(data);
+}
+
+template<class Cloner, class Deleter>
+template<class T, class D>
+inline auto compound<Cloner, Deleter>::forget(const T* data) noexcept
+->decltype(std::declval<const D&>().forget(data)) {
+	return Deleter::forget(data);
+}
+
 template<class Cloner, class Deleter>
 template<class T>
 inline compound<Cloner, Deleter>::
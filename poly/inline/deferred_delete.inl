@@ -0,0 +1,126 @@
+#pragma once
+#include <type_traits> // has_virtual_destructor, remove_cv
+#include "deferred_delete.hpp"
+
+namespace pl {
+namespace detail {
+
+/// Deletes a type-erased Base*
+template <class Base>
+inline void delete_erased(void* ptr) {
+	delete static_cast<Base*>(ptr);
+}
+
+/// State of default_reclaimer(): 0 - not constructed, 1 - alive, 2 - destroyed.
+/// An atomic has a trivial destructor, so it can be read during static
+/// destruction, after the reclaimer itself is gone.
+inline std::atomic<int>& default_reclaimer_state() {
+	static std::atomic<int> rslt(0);
+	return rslt;
+}
+
+} // namespace detail
+
+// class reclaimer =============================================================
+
+inline reclaimer::reclaimer(std::size_t capacity) :
+	queue(capacity),
+	overflow_count(0),
+	running(false) {
+}
+
+inline reclaimer::~reclaimer() {
+	stop();
+	drain();
+}
+
+inline void reclaimer::retire(void* ptr, void (*destroy)(void*)) noexcept {
+	retired r{ptr, destroy};
+
+	if (!queue.try_push(r)) {
+		overflow_count.fetch_add(1, std::memory_order_relaxed);
+		destroy(ptr);
+	}
+}
+
+inline std::size_t reclaimer::drain(std::size_t max) noexcept {
+	std::size_t rslt = 0;
+	retired r{nullptr, nullptr};
+
+	while (rslt < max && queue.try_pop(r)) {
+		r.destroy(r.ptr);
+		++rslt;
+	}
+	return rslt;
+}
+
+inline void reclaimer::start(std::chrono::milliseconds interval) {
+	std::lock_guard<std::mutex> lock(thread_mutex);
+	if (running) return;
+
+	running = true;
+	thread = std::thread(&reclaimer::work, this, interval);
+}
+
+inline void reclaimer::stop() {
+	{
+		std::lock_guard<std::mutex> lock(thread_mutex);
+		if (!running) return;
+		running = false;
+	}
+	wake.notify_all();
+	thread.join();
+}
+
+inline std::size_t reclaimer::overflows() const noexcept {
+	return overflow_count.load(std::memory_order_relaxed);
+}
+
+inline void reclaimer::work(std::chrono::milliseconds interval) {
+	while (true) {
+		if (drain() != 0) continue;
+
+		std::unique_lock<std::mutex> lock(thread_mutex);
+		if (!running) return;
+		wake.wait_for(lock, interval);
+		if (!running) return;
+	}
+}
+
+inline reclaimer& default_reclaimer() {
+	struct holder {
+		holder() { detail::default_reclaimer_state() = 1; }
+		~holder() { detail::default_reclaimer_state() = 2; }
+
+		reclaimer value;
+	};
+
+	static holder rslt;
+	return rslt.value;
+}
+
+inline std::size_t drain() {
+	return default_reclaimer().drain();
+}
+
+// class deferred_delete =======================================================
+
+template<class Base>
+template<class Base2>
+inline deferred_delete<Base>::deferred_delete(const deferred_delete<Base2>&) noexcept {
+}
+
+template<class Base>
+inline void deferred_delete<Base>::operator()(const Base* ptr) const {
+	static_assert(std::has_virtual_destructor<Base>::value,
+		"deferred_delete: Base does not have a virtual destructor, a memory leak will occur.");
+	using raw = typename std::remove_cv<Base>::type;
+
+	if (detail::default_reclaimer_state() == 2) {
+		delete ptr;
+		return;
+	}
+	default_reclaimer().retire(const_cast<raw*>(ptr), &detail::delete_erased<raw>);
+}
+
+} // namespace pl
@@ -49,4 +49,18 @@ inline void pmr_delete<Base>::operator()(const Base* ptr) {
 	destroy_ptr(ptr);
 }
 
+// class in_place_delete =======================================================
+
+template<class Base>
+template<class Base2>
+inline in_place_delete<Base>::in_place_delete(const in_place_delete<Base2>&) noexcept {
+}
+
+template<class Base>
+inline void in_place_delete<Base>::operator()(const Base* ptr) const {
+	static_assert(std::has_virtual_destructor<Base>::value,
+		"in_place_delete: Base does not have a virtual destructor, a resource leak will occur.");
+	ptr->~Base();
+}
+
 } // namespace pl
\ No newline at end of file
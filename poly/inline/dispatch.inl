@@ -0,0 +1,178 @@
+#pragma once
+#include "dispatch.hpp"
+
+namespace pl {
+namespace detail {
+
+// dispatch_throw ==============================================================
+
+template<class R>
+template<class Base1, class Base2>
+inline R dispatch_throw<R>::operator()(Base1& x, Base2& y) const {
+	throw std::invalid_argument(
+		std::string("dispatch: no handler for '") +
+		typeid(x).name() + "' and '" + typeid(y).name() + "'");
+}
+
+// type_indices ================================================================
+
+template<class... Ts>
+template<class Base>
+inline std::size_t type_indices<type_list<Ts...>>::of(const Base& obj) {
+	// type_info objects are looked up by address first, which is the same
+	// for every object of a type, unless the type comes from another module.
+	// In that case, a lookup by name is performed.
+	static const std::type_info* const types[] = {&typeid(void), &typeid(Ts)...};
+
+	static const std::unordered_map<const std::type_info*, std::size_t>
+	by_address = [] {
+		std::unordered_map<const std::type_info*, std::size_t> rslt;
+		for (std::size_t i = 0; i < sizeof...(Ts); ++i) {
+			rslt.emplace(types[i + 1], i);
+		}
+		return rslt;
+	}();
+
+	static const std::unordered_map<std::type_index, std::size_t>
+	by_name = [] {
+		std::unordered_map<std::type_index, std::size_t> rslt;
+		for (std::size_t i = 0; i < sizeof...(Ts); ++i) {
+			rslt.emplace(std::type_index(*types[i + 1]), i);
+		}
+		return rslt;
+	}();
+
+	const std::type_info& type = typeid(obj);
+
+	auto it = by_address.find(&type);
+	if (it != by_address.end()) return it->second;
+
+	auto it2 = by_name.find(std::type_index(type));
+	return it2 != by_name.end() ? it2->second : sizeof...(Ts);
+}
+
+// dispatch_table ==============================================================
+
+template <class R, class Base1, class Base2, class Handlers, class Fallback,
+	bool Symmetric, class... D1s, class... D2s>
+struct dispatch_table<R, Base1, Base2, Handlers, Fallback, Symmetric,
+	type_list<D1s...>, type_list<D2s...>> {
+
+	using cell = R(*)(Base1&, Base2&, Handlers&, Fallback&);
+	using row = std::array<cell, sizeof...(D2s)>;
+	using table = std::array<row, sizeof...(D1s)>;
+
+	// 0 - call handlers(d1, d2), 1 - call handlers(d2, d1), 2 - call fallback
+	template <int N>
+	using choice = std::integral_constant<int, N>;
+
+	template <class D1, class D2>
+	using choice_for = choice<
+		is_callable<Handlers&, D1&, D2&>::value ? 0 :
+		Symmetric && is_callable<Handlers&, D2&, D1&>::value ? 1 : 2>;
+
+	static const table& get() {
+		static const table rslt = {{make_row<D1s>()...}};
+		return rslt;
+	}
+
+	template <class D1>
+	static row make_row() {
+		return row{{&call<D1, D2s>...}};
+	}
+
+	template <class D1, class D2>
+	static R call(Base1& x, Base2& y, Handlers& handlers, Fallback& fallback) {
+		using T1 = same_const<Base1, D1>;
+		using T2 = same_const<Base2, D2>;
+
+		T1& d1 = *inheritance_traits<Base1, D1>::downcast(&x);
+		T2& d2 = *inheritance_traits<Base2, D2>::downcast(&y);
+
+		return invoke(d1, d2, x, y, handlers, fallback, choice_for<T1, T2>());
+	}
+
+	template <class T1, class T2>
+	static R invoke(T1& d1, T2& d2, Base1&, Base2&,
+		Handlers& handlers, Fallback&, choice<0>) {
+		return static_cast<R>(handlers(d1, d2));
+	}
+
+	template <class T1, class T2>
+	static R invoke(T1& d1, T2& d2, Base1&, Base2&,
+		Handlers& handlers, Fallback&, choice<1>) {
+		return static_cast<R>(handlers(d2, d1));
+	}
+
+	template <class T1, class T2>
+	static R invoke(T1&, T2&, Base1& x, Base2& y,
+		Handlers&, Fallback& fallback, choice<2>) {
+		return static_cast<R>(fallback(x, y));
+	}
+};
+
+// Looks up both dynamic types in the lists and calls through the table
+template <bool Symmetric, class List1, class List2,
+	class B1, class P1, class B2, class P2, class Handlers, class Fallback>
+inline typename dispatch_result<Handlers>::type
+dispatch_impl(const poly<B1, P1>& x, const poly<B2, P2>& y,
+	Handlers& handlers, Fallback& fallback) {
+	using R = typename dispatch_result<Handlers>::type;
+	using table = dispatch_table<R, B1, B2, Handlers, Fallback, Symmetric,
+		List1, List2>;
+
+	if (!x || !y)
+		throw std::invalid_argument("dispatch: cannot dispatch on an empty poly");
+
+	std::size_t i = type_indices<List1>::of(*x);
+	std::size_t j = type_indices<List2>::of(*y);
+
+	if (i == List1::size || j == List2::size) {
+		return static_cast<R>(fallback(*x, *y));
+	}
+	return table::get()[i][j](*x, *y, handlers, fallback);
+}
+
+} // namespace detail
+
+// Dispatch ====================================================================
+
+template <class List1, class List2,
+	class B1, class P1, class B2, class P2, class Handlers>
+inline typename detail::dispatch_result<typename std::decay<Handlers>::type>::type
+dispatch(const poly<B1, P1>& x, const poly<B2, P2>& y, Handlers&& handlers) {
+	using H = typename std::remove_reference<Handlers>::type;
+	detail::dispatch_throw<typename detail::dispatch_result<H>::type> fallback;
+
+	return detail::dispatch_impl<false, List1, List2>(x, y, handlers, fallback);
+}
+
+template <class List1, class List2,
+	class B1, class P1, class B2, class P2, class Handlers, class Fallback>
+inline typename detail::dispatch_result<typename std::decay<Handlers>::type>::type
+dispatch(const poly<B1, P1>& x, const poly<B2, P2>& y, Handlers&& handlers,
+	Fallback&& fallback) {
+	return detail::dispatch_impl<false, List1, List2>(x, y, handlers, fallback);
+}
+
+// Symmetric dispatch ==========================================================
+
+template <class List, class B1, class P1, class B2, class P2, class Handlers>
+inline typename detail::dispatch_result<typename std::decay<Handlers>::type>::type
+symmetric_dispatch(const poly<B1, P1>& x, const poly<B2, P2>& y,
+	Handlers&& handlers) {
+	using H = typename std::remove_reference<Handlers>::type;
+	detail::dispatch_throw<typename detail::dispatch_result<H>::type> fallback;
+
+	return detail::dispatch_impl<true, List, List>(x, y, handlers, fallback);
+}
+
+template <class List,
+	class B1, class P1, class B2, class P2, class Handlers, class Fallback>
+inline typename detail::dispatch_result<typename std::decay<Handlers>::type>::type
+symmetric_dispatch(const poly<B1, P1>& x, const poly<B2, P2>& y,
+	Handlers&& handlers, Fallback&& fallback) {
+	return detail::dispatch_impl<true, List, List>(x, y, handlers, fallback);
+}
+
+} // namespace pl
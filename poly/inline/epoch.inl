@@ -0,0 +1,124 @@
+#pragma once
+#include <thread>  // yield
+#include "epoch.hpp"
+
+namespace pl {
+namespace detail {
+
+// class epoch_domain::guard ===================================================
+
+inline epoch_domain::guard::guard() noexcept :
+	rec(instance().local()) {
+	if (rec->nesting++ == 0) {
+		rec->epoch.store(
+			instance().global_epoch.load(std::memory_order_seq_cst),
+			std::memory_order_seq_cst);
+	}
+}
+
+inline epoch_domain::guard::guard(guard&& other) noexcept :
+	rec(other.rec) {
+	other.rec = nullptr;
+}
+
+inline epoch_domain::guard::~guard() {
+	if (rec && --rec->nesting == 0) {
+		rec->epoch.store(0, std::memory_order_release);
+	}
+}
+
+// class epoch_domain ==========================================================
+
+inline epoch_domain::epoch_domain() noexcept :
+	global_epoch(1),
+	records(nullptr) {
+}
+
+inline epoch_domain& epoch_domain::instance() {
+	static epoch_domain* rslt = new epoch_domain;
+	return *rslt;
+}
+
+inline epoch_domain::record* epoch_domain::local() {
+	// Releases the record when the thread exits
+	struct owner {
+		record* rec;
+		~owner() { if (rec) rec->in_use.store(false, std::memory_order_release); }
+	};
+
+	static thread_local owner rslt{nullptr};
+	if (rslt.rec == nullptr) rslt.rec = acquire();
+	return rslt.rec;
+}
+
+inline epoch_domain::record* epoch_domain::acquire() {
+	for (record* r = records.load(std::memory_order_acquire); r; r = r->next) {
+		bool expected = false;
+		if (!r->in_use.load(std::memory_order_relaxed) &&
+			r->in_use.compare_exchange_strong(expected, true, std::memory_order_acquire)) {
+			return r;
+		}
+	}
+
+	record* r = new record;
+	r->epoch.store(0, std::memory_order_relaxed);
+	r->in_use.store(true, std::memory_order_relaxed);
+	r->nesting = 0;
+	r->next = records.load(std::memory_order_relaxed);
+	while (!records.compare_exchange_weak(r->next, r, std::memory_order_release)) {
+	}
+	return r;
+}
+
+inline bool epoch_domain::try_advance() {
+	std::uint64_t epoch = global_epoch.load(std::memory_order_seq_cst);
+
+	for (record* r = records.load(std::memory_order_acquire); r; r = r->next) {
+		std::uint64_t local = r->epoch.load(std::memory_order_seq_cst);
+		if (local != 0 && local != epoch) return false;
+	}
+
+	global_epoch.compare_exchange_strong(epoch, epoch + 1, std::memory_order_seq_cst);
+	return true;
+}
+
+inline void epoch_domain::retire(void* ptr, void (*destroy)(void*)) {
+	{
+		std::lock_guard<std::mutex> lock(retired_mutex);
+		retired_list.push_back(retired{
+			global_epoch.load(std::memory_order_seq_cst), ptr, destroy});
+	}
+	collect();
+}
+
+inline void epoch_domain::synchronize() {
+	std::uint64_t target = global_epoch.load(std::memory_order_seq_cst) + 2;
+
+	while (global_epoch.load(std::memory_order_seq_cst) < target) {
+		if (!try_advance()) std::this_thread::yield();
+	}
+}
+
+inline void epoch_domain::collect() {
+	try_advance();
+	std::uint64_t epoch = global_epoch.load(std::memory_order_seq_cst);
+
+	// Destroy outside of the lock, destructors may retire more objects
+	std::vector<retired> ready;
+	{
+		std::lock_guard<std::mutex> lock(retired_mutex);
+		auto keep = retired_list.begin();
+		for (auto it = retired_list.begin(); it != retired_list.end(); ++it) {
+			if (it->epoch + 2 <= epoch) ready.push_back(*it);
+			else *keep++ = *it;
+		}
+		retired_list.erase(keep, retired_list.end());
+	}
+
+	for (auto&& r : ready) {
+		r.destroy(r.ptr);
+	}
+}
+
+} // namespace detail
+} // namespace pl
@@ -6,51 +6,119 @@ namespace pl {
 
 template <class Base, class CopyDeletePolicy>
 template<class Derived>
-void factory<Base, CopyDeletePolicy>::insert() {
+typename factory<Base, CopyDeletePolicy>::handle
+factory<Base, CopyDeletePolicy>::insert() {
 	static_assert(std::is_base_of<Base, Derived>::value,
 		"factory: factory can only build types, derived from Base");
 	static_assert(std::is_default_constructible<Derived>::value,
 		"factory: factory can only build default-constructible types");
 
-	std::string name(POLY_TYPE_NAME(Derived));
+	return insert_entry(POLY_TYPE_NAME(Derived),
+		entry{&typeid(Derived), &make_default<Derived>, poly_type(),
+		detail::layout_of<Base, Derived>()}, false);
+}
 
-	auto it = std::lower_bound(make_funcs.cbegin(), make_funcs.cend(), name,
-		[](
-		const std::pair<std::string, poly<Base, CopyDeletePolicy>(*)()>& lhs,
-		const std::string& rhs) {
-		return lhs.first < rhs;
-	});
+// Bulk insertion ==============================================================
 
-	if (it == make_funcs.cend() || it->first != name) {
-		make_funcs.insert(it, 
-			std::make_pair(name, &pl::make<poly<Base, CopyDeletePolicy>, Derived>));
-	}
+template <class Base, class CopyDeletePolicy>
+template<class... Derived>
+inline std::array<typename factory<Base, CopyDeletePolicy>::handle, sizeof...(Derived)>
+factory<Base, CopyDeletePolicy>::insert_all() {
+	std::array<registration, sizeof...(Derived)> batch{{registration::template of<Derived>()...}};
+	std::array<handle, sizeof...(Derived)> rslt;
+	insert_batch(batch.data(), batch.size(), rslt.data());
+	return rslt;
+}
+
+template <class Base, class CopyDeletePolicy>
+template <class InputIt, class OutputIt>
+inline OutputIt factory<Base, CopyDeletePolicy>::
+bulk_insert(InputIt first, InputIt last, OutputIt out) {
+	std::vector<registration> batch(first, last);
+	std::vector<handle> ids(batch.size());
+	insert_batch(batch.data(), batch.size(), ids.data());
+	return std::copy(ids.begin(), ids.end(), out);
+}
+
+template <class Base, class CopyDeletePolicy>
+template <class InputIt>
+inline void factory<Base, CopyDeletePolicy>::bulk_insert(InputIt first, InputIt last) {
+	std::vector<registration> batch(first, last);
+	std::vector<handle> ids(batch.size());
+	insert_batch(batch.data(), batch.size(), ids.data());
+}
+
+template <class Base, class CopyDeletePolicy>
+template<class Derived, class... Args>
+typename factory<Base, CopyDeletePolicy>::handle
+factory<Base, CopyDeletePolicy>::insert_prototype(Args&&... args) {
+	static_assert(std::is_base_of<Base, Derived>::value,
+		"factory: factory can only build types, derived from Base");
+
+	return insert_prototype(POLY_TYPE_NAME(Derived),
+		pl::make<poly_type, Derived>(std::forward<Args>(args)...),
+		detail::layout_of<Base, Derived>());
+}
+
+template <class Base, class CopyDeletePolicy>
+typename factory<Base, CopyDeletePolicy>::handle
+factory<Base, CopyDeletePolicy>::
+insert_prototype(std::string name, poly_type prototype) {
+	return insert_prototype(std::move(name), std::move(prototype), nullptr);
+}
+
+template <class Base, class CopyDeletePolicy>
+typename factory<Base, CopyDeletePolicy>::handle
+factory<Base, CopyDeletePolicy>::insert_prototype(std::string name,
+	poly_type prototype, const type_layout<Base>* layout) {
+	if (!prototype)
+		throw std::invalid_argument(
+			std::string("factory: prototype for ") +
+			name +
+			" is empty");
+
+	const std::type_info* type = &typeid(*prototype);
+	return insert_entry(std::move(name),
+		entry{type, &copy_prototype, std::move(prototype), layout}, true);
 }
 
 template <class Base, class CopyDeletePolicy>
 inline std::vector<std::string> factory<Base, CopyDeletePolicy>::list() const {
 	std::vector<std::string> rslt;
-	rslt.reserve(make_funcs.size());
+	rslt.reserve(names.size());
 
-	for (auto&& it : make_funcs) {
+	for (auto&& it : names) {
 		rslt.push_back(it.first);
 	}
 
 	return rslt;
 }
 
+template <class Base, class CopyDeletePolicy>
+inline bool factory<Base, CopyDeletePolicy>::contains(const std::string& name) const {
+	return find(name) != names.cend();
+}
+
+template <class Base, class CopyDeletePolicy>
+inline const std::type_info*
+factory<Base, CopyDeletePolicy>::type_of(const std::string& name) const {
+	auto it = find(name);
+	return it != names.cend() ? make_funcs[it->second].type : nullptr;
+}
+
 template <class Base, class CopyDeletePolicy>
 inline poly<Base, CopyDeletePolicy> 
 factory<Base, CopyDeletePolicy>::make(const std::string& name) const {
-	auto it = std::lower_bound(make_funcs.cbegin(), make_funcs.cend(), name,
-		[](
-		const std::pair<std::string, poly<Base, CopyDeletePolicy>(*)()>& lhs,
-		const std::string& rhs) {
-		return lhs.first < rhs;
-	});
+	return make(id_of(name));
+}
+
+template <class Base, class CopyDeletePolicy>
+inline typename factory<Base, CopyDeletePolicy>::handle
+factory<Base, CopyDeletePolicy>::id_of(const std::string& name) const {
+	auto it = find(name);
 
-	if (it != make_funcs.cend() && it->first == name) {
-		return it->second();
+	if (it != names.cend()) {
+		return it->second;
 	}
 
 	throw std::invalid_argument(
@@ -59,4 +127,258 @@ factory<Base, CopyDeletePolicy>::make(const std::string& name) const {
 		" is not registered in this factory");
 }
 
-} // namespace pl
\ No newline at end of file
+template <class Base, class CopyDeletePolicy>
+template <class InputIt, class OutputIt>
+inline OutputIt factory<Base, CopyDeletePolicy>::
+id_of(InputIt first, InputIt last, OutputIt out) const {
+	// Inputs often repeat the same name many times in a row
+	std::string previous;
+	handle previous_id = names.size();
+
+	for (; first != last; ++first, ++out) {
+		const std::string& name = *first;
+		if (previous_id == names.size() || previous != name) {
+			previous_id = id_of(name);
+			previous = name;
+		}
+		*out = previous_id;
+	}
+	return out;
+}
+
+template <class Base, class CopyDeletePolicy>
+inline poly<Base, CopyDeletePolicy>
+factory<Base, CopyDeletePolicy>::make(handle id) const {
+	const entry& e = entry_of(id);
+	return e.make(e.prototype);
+}
+
+// Layout ======================================================================
+
+template <class Base, class CopyDeletePolicy>
+inline const type_layout<Base>*
+factory<Base, CopyDeletePolicy>::layout_of(const std::string& name) const {
+	auto it = find(name);
+	return it != names.cend() ? make_funcs[it->second].layout : nullptr;
+}
+
+template <class Base, class CopyDeletePolicy>
+inline std::size_t
+factory<Base, CopyDeletePolicy>::size_of(const std::string& name) const {
+	return known_layout(make_funcs[id_of(name)]).size;
+}
+
+template <class Base, class CopyDeletePolicy>
+inline std::size_t
+factory<Base, CopyDeletePolicy>::align_of(const std::string& name) const {
+	return known_layout(make_funcs[id_of(name)]).align;
+}
+
+template <class Base, class CopyDeletePolicy>
+inline std::size_t factory<Base, CopyDeletePolicy>::max_size() const noexcept {
+	std::size_t rslt = 0;
+	for (const entry& e : make_funcs) {
+		if (e.layout && e.layout->size > rslt) rslt = e.layout->size;
+	}
+	return rslt;
+}
+
+template <class Base, class CopyDeletePolicy>
+inline std::size_t factory<Base, CopyDeletePolicy>::max_align() const noexcept {
+	std::size_t rslt = 1;
+	for (const entry& e : make_funcs) {
+		if (e.layout && e.layout->align > rslt) rslt = e.layout->align;
+	}
+	return rslt;
+}
+
+template <class Base, class CopyDeletePolicy>
+inline poly<Base, in_place<Base>> factory<Base, CopyDeletePolicy>::
+construct_at(const std::string& name, void* memory) const {
+	return construct_at(id_of(name), memory);
+}
+
+template <class Base, class CopyDeletePolicy>
+inline poly<Base, in_place<Base>> factory<Base, CopyDeletePolicy>::
+construct_at(handle id, void* memory) const {
+	const entry& e = entry_of(id);
+	const type_layout<Base>& layout = known_layout(e);
+
+	if (!e.prototype) return layout.construct(memory);
+
+	if (!layout.copy)
+		throw std::runtime_error(
+			std::string("factory: prototype of type ") +
+			e.type->name() +
+			" is not copy-constructible");
+	return layout.copy(memory, *e.prototype);
+}
+
+// Private =====================================================================
+
+template <class Base, class CopyDeletePolicy>
+inline typename factory<Base, CopyDeletePolicy>::name_index::const_iterator
+factory<Base, CopyDeletePolicy>::find(const std::string& name) const {
+	auto it = std::lower_bound(names.cbegin(), names.cend(), name,
+		[](const std::pair<std::string, handle>& lhs, const std::string& rhs) {
+		return lhs.first < rhs;
+	});
+
+	return it != names.cend() && it->first == name ? it : names.cend();
+}
+
+template <class Base, class CopyDeletePolicy>
+inline typename factory<Base, CopyDeletePolicy>::handle
+factory<Base, CopyDeletePolicy>::insert_entry(std::string name, entry e, bool replace) {
+	auto it = std::lower_bound(names.begin(), names.end(), name,
+		[](const std::pair<std::string, handle>& lhs, const std::string& rhs) {
+		return lhs.first < rhs;
+	});
+
+	if (it == names.end() || it->first != name) {
+		handle id = make_funcs.size();
+		make_funcs.push_back(std::move(e));
+		names.insert(it, std::make_pair(std::move(name), id));
+		return id;
+	}
+
+	if (replace) {
+		make_funcs[it->second] = std::move(e);
+	}
+	return it->second;
+}
+
+template <class Base, class CopyDeletePolicy>
+inline void factory<Base, CopyDeletePolicy>::
+insert_batch(registration* batch, std::size_t n, handle* ids) {
+	// Registrations of the same name stay in order, so that the last
+	// replacing one wins, as with one by one insertion
+	std::vector<std::size_t> order(n);
+	for (std::size_t i = 0; i < n; ++i) order[i] = i;
+	std::stable_sort(order.begin(), order.end(), [batch](std::size_t x, std::size_t y) {
+		return batch[x].name < batch[y].name;
+	});
+
+	// Walk the sorted batch and names together. A registered name gets its
+	// handle. A new name is recorded by its first registration, the leader,
+	// which gets a handle below.
+	std::vector<bool> added(n);
+	std::vector<std::size_t> leaders; // Sorted by name
+	auto it = names.cbegin();
+	for (std::size_t i = 0; i < n;) {
+		const std::string& name = batch[order[i]].name;
+		it = std::lower_bound(it, names.cend(), name,
+			[](const std::pair<std::string, handle>& lhs, const std::string& rhs) {
+			return lhs.first < rhs;
+		});
+		bool registered = it != names.cend() && it->first == name;
+		if (!registered) leaders.push_back(order[i]);
+
+		for (std::size_t j = i; i < n && batch[order[i]].name == name; ++i) {
+			added[order[i]] = !registered;
+			ids[order[i]] = registered ? it->second : order[j];
+		}
+	}
+
+	// New handles are given in order of registration
+	make_funcs.reserve(make_funcs.size() + leaders.size());
+	names.reserve(names.size() + leaders.size());
+	for (std::size_t i = 0; i < n; ++i) {
+		if (added[i] && ids[i] == i) {
+			ids[i] = make_funcs.size();
+			make_funcs.push_back(std::move(batch[i].e));
+		}
+		else {
+			if (added[i]) ids[i] = ids[ids[i]];
+			if (batch[i].replace) make_funcs[ids[i]] = std::move(batch[i].e);
+		}
+	}
+
+	auto middle = names.size();
+	for (std::size_t i : leaders) {
+		names.push_back(std::make_pair(std::move(batch[i].name), ids[i]));
+	}
+	std::inplace_merge(names.begin(), names.begin() + middle, names.end(),
+		[](const std::pair<std::string, handle>& lhs, const std::pair<std::string, handle>& rhs) {
+		return lhs.first < rhs.first;
+	});
+}
+
+template <class Base, class CopyDeletePolicy>
+inline const typename factory<Base, CopyDeletePolicy>::entry&
+factory<Base, CopyDeletePolicy>::entry_of(handle id) const {
+	if (id >= make_funcs.size())
+		throw std::out_of_range(
+			std::string("factory: handle ") +
+			std::to_string(id) +
+			" is not registered in this factory");
+
+	return make_funcs[id];
+}
+
+template <class Base, class CopyDeletePolicy>
+inline const type_layout<Base>&
+factory<Base, CopyDeletePolicy>::known_layout(const entry& e) {
+	if (!e.layout)
+		throw std::invalid_argument(
+			std::string("factory: layout of type ") +
+			e.type->name() +
+			" is not known, its prototype was inserted as a poly");
+
+	return *e.layout;
+}
+
+// Prototypes are copied through the policy's clone, e.g. deep_copy
+template <class Base, class CopyDeletePolicy>
+inline poly<Base, CopyDeletePolicy>
+factory<Base, CopyDeletePolicy>::copy_prototype(const poly_type& prototype) {
+	return prototype;
+}
+
+template <class Base, class CopyDeletePolicy>
+template<class Derived>
+inline poly<Base, CopyDeletePolicy>
+factory<Base, CopyDeletePolicy>::make_default(const poly_type&) {
+	return pl::make<poly_type, Derived>();
+}
+
+// class registration ==========================================================
+
+template <class Base, class CopyDeletePolicy>
+template <class Derived>
+inline typename factory<Base, CopyDeletePolicy>::registration
+factory<Base, CopyDeletePolicy>::registration::of() {
+	static_assert(std::is_base_of<Base, Derived>::value,
+		"factory: factory can only build types, derived from Base");
+	static_assert(std::is_default_constructible<Derived>::value,
+		"factory: factory can only build default-constructible types");
+
+	return registration(POLY_TYPE_NAME(Derived),
+		entry{&typeid(Derived), &make_default<Derived>, poly_type(),
+		detail::layout_of<Base, Derived>()}, false);
+}
+
+template <class Base, class CopyDeletePolicy>
+inline factory<Base, CopyDeletePolicy>::registration::
+registration(std::string name, poly<Base, CopyDeletePolicy> prototype) :
+	name(std::move(name)),
+	e{nullptr, &copy_prototype, std::move(prototype), nullptr},
+	replace(true) {
+	if (!e.prototype)
+		throw std::invalid_argument(
+			std::string("factory: prototype for ") +
+			this->name +
+			" is empty");
+
+	e.type = &typeid(*e.prototype);
+}
+
+template <class Base, class CopyDeletePolicy>
+inline factory<Base, CopyDeletePolicy>::registration::
+registration(std::string name, entry e, bool replace) :
+	name(std::move(name)),
+	e(std::move(e)),
+	replace(replace) {
+}
+
+} // namespace pl
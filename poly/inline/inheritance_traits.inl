@@ -5,7 +5,10 @@ namespace pl {
 namespace detail {
 
 template <class Base, class Derived>
-std::atomic<std::ptrdiff_t> inheritance_traits_impl<Base, Derived>::offset;
+constexpr std::ptrdiff_t inheritance_traits_impl<Base, Derived>::unknown;
+
+template <class Base, class Derived>
+std::atomic<std::ptrdiff_t> inheritance_traits_impl<Base, Derived>::offset(unknown);
 
 template<class Base, class Derived>
 inline void inheritance_traits_impl<Base, Derived>::
@@ -15,16 +18,26 @@ set_offset(const Base* base_ptr, const Derived* derived_ptr) {
 		reinterpret_cast<const unsigned char*>(base_ptr);
 }
 
+template<class Base, class Derived>
+inline std::ptrdiff_t inheritance_traits_impl<Base, Derived>::get_offset(const Base* ptr) {
+	std::ptrdiff_t rslt = offset.load(std::memory_order_relaxed);
+	if (rslt == unknown) {
+		set_offset(ptr, dynamic_cast<const Derived*>(ptr));
+		rslt = offset.load(std::memory_order_relaxed);
+	}
+	return rslt;
+}
+
 template<class Base, class Derived>
 inline Derived* inheritance_traits_impl<Base, Derived>::downcast(Base* ptr) {
 	return reinterpret_cast<Derived*>(
-		reinterpret_cast<unsigned char*>(ptr) + offset);
+		reinterpret_cast<unsigned char*>(ptr) + get_offset(ptr));
 }
 
 template<class Base, class Derived>
 inline const Derived* inheritance_traits_impl<Base, Derived>::downcast(const Base* ptr) {
 	return reinterpret_cast<const Derived*>(
-		reinterpret_cast<const unsigned char*>(ptr) + offset);
+		reinterpret_cast<const unsigned char*>(ptr) + get_offset(ptr));
 }
 
 } // namespace detail
@@ -0,0 +1,127 @@
+#pragma once
+#include <algorithm> // min_element
+#include <iterator>  // begin, end
+#include <stdexcept> // invalid_argument
+#include <type_traits> // remove_reference
+#include <utility>   // forward, swap
+#include "inline_cache.hpp"
+#include "inheritance_traits.hpp"
+
+namespace pl {
+namespace detail {
+
+/// A table of functions, one for every type in List, and one for other
+/// types, that downcast the object and call the handler.
+template <class R, class Base, class Handler, class List>
+struct cache_thunks;
+
+template <class R, class Base, class Handler, class... Ts>
+struct cache_thunks<R, Base, Handler, type_list<Ts...>> {
+	using thunk = R(*)(Handler&, Base*);
+
+	template <class T>
+	static R invoke(Handler& handler, Base* obj) {
+		return handler(*inheritance_traits<Base, T>::downcast(obj));
+	}
+
+	static R fallback(Handler& handler, Base* obj) {
+		return handler(*obj);
+	}
+
+	static const thunk* table() {
+		static const thunk rslt[] = {&invoke<Ts>..., &fallback};
+		return rslt;
+	}
+};
+
+} // namespace detail
+
+template<class Base, std::size_t K, class List>
+constexpr std::size_t inline_cache<Base, K, List>::decay_period;
+
+template<class Base, std::size_t K, class List>
+inline inline_cache<Base, K, List>::inline_cache() noexcept :
+	hit_count(0),
+	miss_count(0) {
+	for (auto& e : entries) e = entry{nullptr, List::size, 0};
+}
+
+template<class Base, std::size_t K, class List>
+template<class CopyDeletePolicy, class Handler>
+inline typename detail::dispatch_result<typename std::decay<Handler>::type>::type
+inline_cache<Base, K, List>::
+operator()(const poly<Base, CopyDeletePolicy>& p, Handler&& handler) {
+	using handler_type = typename std::remove_reference<Handler>::type;
+	using result_type = typename detail::dispatch_result<
+		typename std::decay<Handler>::type>::type;
+	using thunks = detail::cache_thunks<result_type, Base, handler_type, List>;
+
+	if (!p) throw std::invalid_argument("inline_cache: poly is empty");
+
+	const std::type_info* type = &typeid(*p);
+	for (auto& e : entries) {
+		if (e.type == type) {
+			++e.count;
+			++hit_count;
+			return thunks::table()[e.index](handler, p.get());
+		}
+	}
+
+	return thunks::table()[miss(*p)](handler, p.get());
+}
+
+template<class Base, std::size_t K, class List>
+inline std::size_t inline_cache<Base, K, List>::miss(const Base& obj) {
+	const std::type_info* type = &typeid(obj);
+	++miss_count;
+
+	if (miss_count % decay_period == 0) {
+		for (auto& e : entries) e.count /= 2;
+		for (auto& c : candidates) c.count /= 2;
+	}
+
+	auto candidate = candidates.begin();
+	while (candidate != candidates.end() && candidate->type != type) ++candidate;
+	if (candidate == candidates.end()) {
+		candidates.push_back(entry{type, detail::type_indices<List>::of(obj), 0});
+		candidate = candidates.end() - 1;
+	}
+	++candidate->count;
+
+	// Replace the least common cached type, if the candidate is more common
+	entry* least = std::min_element(std::begin(entries), std::end(entries),
+		[](const entry& x, const entry& y) { return x.count < y.count; });
+	std::size_t index = candidate->index;
+	if (least->type == nullptr || candidate->count > least->count) {
+		std::swap(*least, *candidate);
+		if (candidate->type == nullptr) candidates.erase(candidate);
+	}
+
+	return index;
+}
+
+// Counters ====================================================================
+
+template<class Base, std::size_t K, class List>
+inline std::size_t inline_cache<Base, K, List>::hits() const noexcept {
+	return hit_count;
+}
+
+template<class Base, std::size_t K, class List>
+inline std::size_t inline_cache<Base, K, List>::misses() const noexcept {
+	return miss_count;
+}
+
+template<class Base, std::size_t K, class List>
+inline double inline_cache<Base, K, List>::hit_rate() const noexcept {
+	std::size_t calls = hit_count + miss_count;
+	return calls == 0 ? 0 : static_cast<double>(hit_count) / calls;
+}
+
+template<class Base, std::size_t K, class List>
+inline void inline_cache<Base, K, List>::reset_counters() noexcept {
+	hit_count = 0;
+	miss_count = 0;
+}
+
+} // namespace pl
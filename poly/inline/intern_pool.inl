@@ -0,0 +1,103 @@
+#pragma once
+#include <typeindex> // type_index
+#include <utility>   // move
+#include "intern_pool.hpp"
+
+namespace pl {
+
+// struct node_deleter =========================================================
+
+template<class Base, class Hash, class Equal, class CopyDeletePolicy>
+inline void intern_pool<Base, Hash, Equal, CopyDeletePolicy>::node_deleter::
+operator()(node* ptr) const {
+	{
+		std::lock_guard<std::mutex> lock(owner->mutex);
+		auto range = owner->slots.equal_range(ptr->hash);
+		for (auto it = range.first; it != range.second; ++it) {
+			if (it->second.ptr == ptr) {
+				owner->slots.erase(it);
+				break;
+			}
+		}
+	}
+
+	delete ptr;
+}
+
+// class intern_pool ===========================================================
+
+template<class Base, class Hash, class Equal, class CopyDeletePolicy>
+inline intern_pool<Base, Hash, Equal, CopyDeletePolicy>::
+intern_pool(std::size_t shard_count, const Hash& hash, const Equal& equal) :
+	hash(hash),
+	equal(equal) {
+	if (shard_count == 0) shard_count = 1;
+
+	shards.reserve(shard_count);
+	for (std::size_t i = 0; i < shard_count; ++i) {
+		shards.push_back(std::make_shared<shard>());
+	}
+}
+
+template<class Base, class Hash, class Equal, class CopyDeletePolicy>
+inline typename intern_pool<Base, Hash, Equal, CopyDeletePolicy>::handle
+intern_pool<Base, Hash, Equal, CopyDeletePolicy>::intern(poly_type value) {
+	if (!value) return handle();
+
+	const std::size_t h = hash_of(*value);
+	const std::shared_ptr<shard>& owner = shards[h % shards.size()];
+	{
+		std::lock_guard<std::mutex> lock(owner->mutex);
+		handle rslt = find(*owner, h, *value);
+		if (rslt) return rslt;
+	}
+
+	// The node is made without the lock: if anything throws, or another
+	// thread interns an equal object first, the node's deleter must be able
+	// to lock the shard.
+	const Base* obj = value.get();
+	std::shared_ptr<node> created(new node{std::move(value), h}, node_deleter{owner});
+
+	std::lock_guard<std::mutex> lock(owner->mutex);
+	handle rslt = find(*owner, h, *obj);
+	if (rslt) return rslt;
+
+	owner->slots.emplace(h, slot{created.get(), created});
+	return handle(created, obj);
+}
+
+template<class Base, class Hash, class Equal, class CopyDeletePolicy>
+inline typename intern_pool<Base, Hash, Equal, CopyDeletePolicy>::handle
+intern_pool<Base, Hash, Equal, CopyDeletePolicy>::
+find(shard& s, std::size_t h, const Base& obj) const {
+	auto range = s.slots.equal_range(h);
+	for (auto it = range.first; it != range.second; ++it) {
+		// Nodes are only deleted after their slot is erased, so the object is
+		// alive while s is locked, even if its last handle is being destroyed
+		const Base& canonical = *it->second.ptr->value;
+		if (typeid(canonical) != typeid(obj) || !equal(canonical, obj)) continue;
+
+		std::shared_ptr<node> rslt = it->second.ref.lock();
+		if (rslt) return handle(rslt, &canonical);
+	}
+	return handle();
+}
+
+template<class Base, class Hash, class Equal, class CopyDeletePolicy>
+inline std::size_t intern_pool<Base, Hash, Equal, CopyDeletePolicy>::size() const {
+	std::size_t rslt = 0;
+	for (auto& s : shards) {
+		std::lock_guard<std::mutex> lock(s->mutex);
+		rslt += s->slots.size();
+	}
+	return rslt;
+}
+
+template<class Base, class Hash, class Equal, class CopyDeletePolicy>
+inline std::size_t
+intern_pool<Base, Hash, Equal, CopyDeletePolicy>::hash_of(const Base& obj) const {
+	std::size_t type_hash = std::hash<std::type_index>()(typeid(obj));
+	return type_hash ^ (hash(obj) + 0x9e3779b9 + (type_hash << 6) + (type_hash >> 2));
+}
+
+} // namespace pl
@@ -0,0 +1,268 @@
+#pragma once
+#include <algorithm>   // reverse
+#include <cstdint>     // uintptr_t
+#include <type_traits> // has_virtual_destructor, is_polymorphic
+#include "iterative_policies.hpp"
+#include "copy_policies.hpp"
+#include "inheritance_traits.hpp"
+
+namespace pl {
+namespace detail {
+
+// class clone_memo ============================================================
+
+inline clone_memo::clone_memo() noexcept :
+	count(0) {
+}
+
+inline void clone_memo::reserve_one() {
+	// At most half full, so that probes stay short
+	if (2 * (count + 1) <= slots.size()) return;
+
+	std::vector<std::pair<const void*, void*>> old(slots.size() < 32 ? 64 : 2 * slots.size());
+	old.swap(slots);
+	count = 0;
+	for (auto& slot : old) {
+		if (slot.first) insert(slot.first, slot.second);
+	}
+}
+
+inline void clone_memo::insert(const void* source, void* copy) noexcept {
+	std::size_t i = slot_of(source);
+	if (!slots[i].first) ++count;
+	slots[i] = std::make_pair(source, copy);
+}
+
+inline void* clone_memo::find(const void* source) const noexcept {
+	if (slots.empty()) return nullptr;
+	return slots[slot_of(source)].second;
+}
+
+inline std::size_t clone_memo::slot_of(const void* source) const noexcept {
+	std::size_t mask = slots.size() - 1;
+	std::size_t h = reinterpret_cast<std::uintptr_t>(source) >> 4;
+	h ^= h >> 16;
+
+	std::size_t i = h & mask;
+	while (slots[i].first && slots[i].first != source) i = (i + 1) & mask;
+	return i;
+}
+
+// Iterative state =============================================================
+
+inline clone_state*& iterative_cloning() noexcept {
+	static thread_local clone_state* rslt = nullptr;
+	return rslt;
+}
+
+inline iterative_state& iterative_local() {
+	static thread_local iterative_state rslt{false, {}};
+	return rslt;
+}
+
+template <class Base>
+inline void iterative_destroy(const void* ptr) {
+	delete static_cast<const Base*>(ptr);
+}
+
+/// Copies other. With Memo, records the copy for iterative_clone_of. Derived
+/// is the most derived type, as poly checks on adoption, so the addresses of
+/// both objects are found without dynamic_cast.
+template <class Base, class Derived, bool Memo>
+inline Base* iterative_clone(const Base* other) {
+	if (!Memo) return clone<Base, Derived>(other);
+
+	clone_memo& copies = iterative_cloning()->copies;
+	copies.reserve_one();
+	Base* rslt = clone<Base, Derived>(other);
+	copies.insert(inheritance_traits<Base, Derived>::downcast(other),
+		inheritance_traits<Base, Derived>::downcast(rslt));
+	return rslt;
+}
+
+/// Placeholder, that a poly holds until its copy is made by the task at
+/// index. Objects are never at odd addresses, as they hold a vtable pointer.
+template <class Base>
+inline Base* pending_copy(std::size_t index) noexcept {
+	return reinterpret_cast<Base*>((static_cast<std::uintptr_t>(index) << 1) | 1);
+}
+
+inline bool is_pending_copy(const void* ptr) noexcept {
+	return (reinterpret_cast<std::uintptr_t>(ptr) & 1) != 0;
+}
+
+inline std::size_t pending_index(const void* ptr) noexcept {
+	return static_cast<std::size_t>(reinterpret_cast<std::uintptr_t>(ptr) >> 1);
+}
+
+template <class Base>
+inline void iterative_run(const clone_task& task) {
+	using clone_function = typename std::remove_const<Base>::type* (*)(const Base*);
+
+	// Empty, if the copy throws
+	Base*& target = *static_cast<Base**>(task.target);
+	target = nullptr;
+	target = reinterpret_cast<clone_function>(task.clone)(static_cast<const Base*>(task.source));
+}
+
+template <class Base>
+inline void iterative_relink(const clone_task& task, std::size_t index) {
+	*static_cast<Base**>(task.target) =
+		index == clone_task::npos ? nullptr : pending_copy<Base>(index);
+}
+
+/// Reverses the tasks from first, so that they run in the order they were
+/// added, and gives their polys the new indices
+inline void iterative_reorder(std::vector<clone_task>& tasks, std::size_t first) {
+	if (tasks.size() - first < 2) return;
+
+	std::reverse(tasks.begin() + first, tasks.end());
+	for (std::size_t i = first; i < tasks.size(); ++i) {
+		if (tasks[i].target) tasks[i].relink(tasks[i], i);
+	}
+}
+
+} // namespace detail
+
+// class iterative_copy ========================================================
+
+template<class Base, bool Memo>
+constexpr iterative_copy<Base, Memo>::iterative_copy() noexcept :
+	clone_ptr(nullptr) {
+}
+
+template<class Base, bool Memo>
+template<class Base2>
+inline iterative_copy<Base, Memo>::
+iterative_copy(const iterative_copy<Base2, Memo>& other) noexcept :
+	clone_ptr(other.clone_ptr) {
+}
+
+template<class Base, bool Memo>
+template<class Derived>
+inline iterative_copy<Base, Memo>::iterative_copy(const Derived*) :
+	clone_ptr(&detail::iterative_clone<Base, Derived, Memo>) {
+	static_assert(std::is_base_of<Base, Derived>::value,
+		"iterative_copy: Base is not base of Derived");
+}
+
+template<class Base, bool Memo>
+inline Base* iterative_copy<Base, Memo>::operator()(const Base* other) {
+	detail::clone_state*& current = detail::iterative_cloning();
+
+	if (current) {
+		// Copied later, when the outermost copy reaches the task. A copy of a
+		// poly, that waits for its own copy, is another copy of the same object.
+		detail::clone_state& s = *current;
+		detail::clone_task task = detail::is_pending_copy(other) ?
+			s.clone_list[detail::pending_index(other)] :
+			detail::clone_task{nullptr, other, &detail::iterative_run<Base>,
+				&detail::iterative_relink<Base>, reinterpret_cast<void (*)()>(clone_ptr)};
+		task.target = nullptr;
+		s.clone_list.push_back(task);
+		return detail::pending_copy<Base>(s.clone_list.size() - 1);
+	}
+
+	detail::clone_state s{{}, {}};
+	current = &s;
+	typename std::remove_const<Base>::type* rslt = nullptr;
+	try {
+		rslt = clone_ptr(other);
+		detail::iterative_reorder(s.clone_list, 0);
+
+		// Children of each object are copied in the order they are reached, as
+		// recursive copies do, so that copies are laid out like the originals
+		while (!s.clone_list.empty()) {
+			detail::clone_task task = s.clone_list.back();
+			s.clone_list.pop_back();
+			if (!task.target) continue;
+
+			std::size_t reached = s.clone_list.size();
+			task.run(task);
+			detail::iterative_reorder(s.clone_list, reached);
+		}
+	}
+	catch (...) {
+		// Polys, that were not reached, are left empty, and the copy is destroyed
+		for (auto& task : s.clone_list) {
+			if (task.target) task.relink(task, detail::clone_task::npos);
+		}
+		current = nullptr;
+		iterative_delete<Base>()(rslt);
+		throw;
+	}
+
+	current = nullptr;
+	return rslt;
+}
+
+// class iterative_delete ======================================================
+
+template<class Base>
+template<class Base2>
+inline iterative_delete<Base>::iterative_delete(const iterative_delete<Base2>&) noexcept {
+}
+
+template<class Base>
+inline void iterative_delete<Base>::operator()(const Base* ptr) const {
+	static_assert(std::has_virtual_destructor<Base>::value,
+		"iterative_delete: Base does not have a virtual destructor, a memory leak will occur.");
+	if (!ptr) return;
+
+	if (detail::is_pending_copy(ptr)) {
+		// The poly was dropped before its copy was made
+		detail::iterative_cloning()->clone_list[detail::pending_index(ptr)].target = nullptr;
+		return;
+	}
+
+	detail::iterative_state& s = detail::iterative_local();
+	if (s.destroying) {
+		try {
+			s.destroy_list.push_back(std::make_pair(ptr, &detail::iterative_destroy<Base>));
+			return;
+		}
+		catch (...) {
+			// Out of memory, the object is destroyed recursively
+			delete ptr;
+			return;
+		}
+	}
+
+	s.destroying = true;
+	delete ptr;
+	while (!s.destroy_list.empty()) {
+		auto next = s.destroy_list.back();
+		s.destroy_list.pop_back();
+		next.second(next.first);
+	}
+	s.destroying = false;
+}
+
+template<class Base>
+inline void iterative_delete<Base>::adopt(Base*& data) const noexcept {
+	if (!detail::is_pending_copy(data)) return;
+
+	detail::iterative_cloning()->clone_list[detail::pending_index(data)].target = &data;
+}
+
+// iterative_clone_of ==========================================================
+
+template <class T>
+inline T* iterative_clone_of(const T* source) {
+	static_assert(std::is_polymorphic<T>::value,
+		"iterative_clone_of: T must be polymorphic");
+
+	detail::clone_state* s = detail::iterative_cloning();
+	if (!source || !s) return nullptr;
+
+	const void* most_derived = dynamic_cast<const void*>(source);
+	void* copy = s->copies.find(most_derived);
+	if (!copy) return nullptr;
+
+	// T is at the same offset in both objects
+	return reinterpret_cast<T*>(static_cast<unsigned char*>(copy) +
+		(reinterpret_cast<const unsigned char*>(source) -
+		static_cast<const unsigned char*>(most_derived)));
+}
+
+} // namespace pl
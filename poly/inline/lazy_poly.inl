@@ -0,0 +1,123 @@
+#pragma once
+#include <utility> // move
+#include "lazy_poly.hpp"
+
+namespace pl {
+
+// Construction ================================================================
+
+template<class Base, class CopyDeletePolicy>
+inline lazy_poly<Base, CopyDeletePolicy>::lazy_poly() noexcept :
+	source(nullptr),
+	cache(nullptr) {
+}
+
+template<class Base, class CopyDeletePolicy>
+inline lazy_poly<Base, CopyDeletePolicy>::
+lazy_poly(const factory_type& f, std::string name) :
+	source(&f),
+	type_name(std::move(name)),
+	cache(nullptr) {
+}
+
+template<class Base, class CopyDeletePolicy>
+inline lazy_poly<Base, CopyDeletePolicy>::lazy_poly(const lazy_poly& other) :
+	source(other.source),
+	type_name(other.type_name),
+	value(other.value),
+	cache(value.get()) {
+}
+
+template<class Base, class CopyDeletePolicy>
+inline lazy_poly<Base, CopyDeletePolicy>::lazy_poly(lazy_poly&& other) noexcept :
+	source(other.source),
+	type_name(std::move(other.type_name)),
+	value(std::move(other.value)),
+	cache(value.get()) {
+	other.cache.store(nullptr, std::memory_order_relaxed);
+}
+
+template<class Base, class CopyDeletePolicy>
+inline lazy_poly<Base, CopyDeletePolicy>&
+lazy_poly<Base, CopyDeletePolicy>::operator=(const lazy_poly& other) {
+	source = other.source;
+	type_name = other.type_name;
+	value = other.value;
+	cache.store(value.get(), std::memory_order_release);
+
+	return *this;
+}
+
+template<class Base, class CopyDeletePolicy>
+inline lazy_poly<Base, CopyDeletePolicy>&
+lazy_poly<Base, CopyDeletePolicy>::operator=(lazy_poly&& other) noexcept {
+	source = other.source;
+	type_name = std::move(other.type_name);
+	value = std::move(other.value);
+	cache.store(value.get(), std::memory_order_release);
+	other.cache.store(nullptr, std::memory_order_relaxed);
+
+	return *this;
+}
+
+// Observers ===================================================================
+
+template<class Base, class CopyDeletePolicy>
+template<class T>
+inline bool lazy_poly<Base, CopyDeletePolicy>::is() const {
+	if (Base* obj = cache.load(std::memory_order_acquire)) {
+		return typeid(*obj) == typeid(T);
+	}
+
+	const std::type_info* type = source ? source->type_of(type_name) : nullptr;
+	return type != nullptr && *type == typeid(T);
+}
+
+template<class Base, class CopyDeletePolicy>
+inline bool lazy_poly<Base, CopyDeletePolicy>::constructed() const noexcept {
+	return cache.load(std::memory_order_acquire) != nullptr;
+}
+
+template<class Base, class CopyDeletePolicy>
+inline const std::string& lazy_poly<Base, CopyDeletePolicy>::name() const noexcept {
+	return type_name;
+}
+
+// Member access ===============================================================
+
+template<class Base, class CopyDeletePolicy>
+inline Base& lazy_poly<Base, CopyDeletePolicy>::operator*() const {
+	return *get();
+}
+
+template<class Base, class CopyDeletePolicy>
+inline Base* lazy_poly<Base, CopyDeletePolicy>::operator->() const {
+	return get();
+}
+
+template<class Base, class CopyDeletePolicy>
+inline Base* lazy_poly<Base, CopyDeletePolicy>::get() const {
+	Base* rslt = cache.load(std::memory_order_acquire);
+	return rslt ? rslt : construct();
+}
+
+template<class Base, class CopyDeletePolicy>
+template<class T>
+inline T* lazy_poly<Base, CopyDeletePolicy>::as() const {
+	get();
+	return value.template as<T>();
+}
+
+template<class Base, class CopyDeletePolicy>
+inline Base* lazy_poly<Base, CopyDeletePolicy>::construct() const {
+	if (source == nullptr) return nullptr;
+
+	std::lock_guard<std::mutex> lock(init_mutex);
+	if (!value) {
+		value = source->make(type_name);
+		cache.store(value.get(), std::memory_order_release);
+	}
+	return value.get();
+}
+
+} // namespace pl
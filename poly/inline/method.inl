@@ -0,0 +1,30 @@
+#pragma once
+#include <utility> // forward
+#include "method.hpp"
+
+namespace pl {
+
+template <class R, class... Args>
+constexpr bool method<R(Args...)>::is_const;
+
+template <class R, class... Args>
+constexpr bool method<R(Args...) const>::is_const;
+
+namespace detail {
+
+template <class Method, class T, class R, class... Args>
+struct method_thunk<Method, T, R(*)(void*, Args...)> {
+	static R invoke(void* obj, Args... args) {
+		return Method::call(*static_cast<T*>(obj), std::forward<Args>(args)...);
+	}
+};
+
+template <class Method, class T, class R, class... Args>
+struct method_thunk<Method, T, R(*)(const void*, Args...)> {
+	static R invoke(const void* obj, Args... args) {
+		return Method::call(*static_cast<const T*>(obj), std::forward<Args>(args)...);
+	}
+};
+
+} // namespace detail
+} // namespace pl
@@ -0,0 +1,225 @@
+#pragma once
+#include <algorithm> // min
+#include <iterator>  // begin, end, distance
+#include <utility>   // move
+#include "parallel.hpp"
+
+namespace pl {
+
+// class thread_pool ===========================================================
+
+inline thread_pool::thread_pool(std::size_t threads) :
+	next_queue(0),
+	pending(0),
+	stopping(false) {
+	if (threads == 0) threads = 1;
+
+	for (std::size_t i = 0; i < threads; ++i) {
+		queues.emplace_back(new task_queue);
+	}
+	for (std::size_t i = 0; i < threads; ++i) {
+		this->threads.emplace_back(&thread_pool::work, this, i);
+	}
+}
+
+inline thread_pool::~thread_pool() {
+	{
+		std::lock_guard<std::mutex> lock(state_mutex);
+		stopping = true;
+	}
+	wake.notify_all();
+
+	for (auto&& t : threads) {
+		t.join();
+	}
+}
+
+inline std::size_t thread_pool::size() const noexcept {
+	return threads.size();
+}
+
+inline void thread_pool::execute(std::function<void()> task) {
+	std::size_t index = next_queue.fetch_add(1, std::memory_order_relaxed) % queues.size();
+	{
+		// A worker, that pops the task, needs state_mutex to count it as done,
+		// so it's counted here first
+		std::lock_guard<std::mutex> state_lock(state_mutex);
+		{
+			std::lock_guard<std::mutex> lock(queues[index]->mutex);
+			queues[index]->tasks.push_back(std::move(task));
+		}
+		++pending;
+	}
+	wake.notify_one();
+}
+
+inline void thread_pool::work(std::size_t index) {
+	std::function<void()> task;
+
+	while (true) {
+		if (try_pop(index, task)) {
+			{
+				std::lock_guard<std::mutex> lock(state_mutex);
+				--pending;
+			}
+			task();
+			task = nullptr;
+			continue;
+		}
+
+		std::unique_lock<std::mutex> lock(state_mutex);
+		wake.wait(lock, [this] { return stopping || pending > 0; });
+		if (stopping && pending == 0) return;
+	}
+}
+
+inline bool thread_pool::try_pop(std::size_t index, std::function<void()>& task) {
+	// Own queue first, from the front
+	{
+		task_queue& own = *queues[index];
+		std::lock_guard<std::mutex> lock(own.mutex);
+		if (!own.tasks.empty()) {
+			task = std::move(own.tasks.front());
+			own.tasks.pop_front();
+			return true;
+		}
+	}
+
+	// Then steal from others, from the back
+	for (std::size_t i = 1; i < queues.size(); ++i) {
+		task_queue& other = *queues[(index + i) % queues.size()];
+		std::lock_guard<std::mutex> lock(other.mutex);
+		if (!other.tasks.empty()) {
+			task = std::move(other.tasks.back());
+			other.tasks.pop_back();
+			return true;
+		}
+	}
+
+	return false;
+}
+
+inline thread_pool& default_pool() {
+	static thread_pool rslt;
+	return rslt;
+}
+
+namespace detail {
+
+// class task_group ============================================================
+
+inline task_group::task_group(std::size_t count) noexcept :
+	remaining(count) {
+}
+
+inline void task_group::done(std::exception_ptr error) {
+	std::lock_guard<std::mutex> lock(mutex);
+	if (error && !first_error) first_error = error;
+	if (--remaining == 0) finished.notify_all();
+}
+
+inline void task_group::wait() {
+	std::unique_lock<std::mutex> lock(mutex);
+	finished.wait(lock, [this] { return remaining == 0; });
+	if (first_error) std::rethrow_exception(first_error);
+}
+
+// Executor concurrency ========================================================
+// Number of threads of an executor: size() if provided, hardware otherwise
+
+template <class Executor>
+inline auto concurrency(const Executor& executor, int) -> decltype(executor.size()) {
+	return executor.size();
+}
+
+template <class Executor>
+inline std::size_t concurrency(const Executor&, long) {
+	return std::thread::hardware_concurrency();
+}
+
+template <class Executor, class F>
+inline void parallel_for(Executor& executor, std::size_t n, F f) {
+	if (n == 0) return;
+
+	// A few chunks per thread, so that stealing can even out the load
+	std::size_t threads = static_cast<std::size_t>(concurrency(executor, 0));
+	std::size_t chunks = std::min(n, (threads == 0 ? 1 : threads) * 4);
+	std::size_t chunk_size = (n + chunks - 1) / chunks;
+	chunks = (n + chunk_size - 1) / chunk_size;
+
+	task_group group(chunks);
+	std::size_t submitted = 0;
+	try {
+		for (; submitted < chunks; ++submitted) {
+			std::size_t first = submitted * chunk_size;
+			std::size_t last = std::min(n, first + chunk_size);
+
+			executor.execute([&group, &f, first, last] {
+				try {
+					f(first, last);
+					group.done();
+				}
+				catch (...) {
+					group.done(std::current_exception());
+				}
+			});
+		}
+	}
+	catch (...) {
+		// Chunks, that were submitted, use group and f, so they must finish
+		// before the error is passed on
+		for (; submitted < chunks; ++submitted) group.done();
+		try {
+			group.wait();
+		}
+		catch (...) {
+		}
+		throw;
+	}
+	group.wait();
+}
+
+} // namespace detail
+
+// Parallel make ===============================================================
+
+template <class Factory, class NameRange, class RandomIt, class Executor>
+inline RandomIt parallel_make(const Factory& f, const NameRange& names,
+	RandomIt out, Executor& executor) {
+	auto first = std::begin(names);
+	std::size_t n = static_cast<std::size_t>(std::distance(first, std::end(names)));
+
+	detail::parallel_for(executor, n, [&](std::size_t i, std::size_t last) {
+		for (; i < last; ++i) {
+			out[i] = f.make(first[i]);
+		}
+	});
+
+	return out + n;
+}
+
+template <class Factory, class NameRange, class RandomIt>
+inline RandomIt parallel_make(const Factory& f, const NameRange& names, RandomIt out) {
+	return parallel_make(f, names, out, default_pool());
+}
+
+// Parallel destroy ============================================================
+
+template <class Range, class Executor>
+inline void parallel_destroy(Range& range, Executor& executor) {
+	auto first = std::begin(range);
+	std::size_t n = static_cast<std::size_t>(std::distance(first, std::end(range)));
+
+	detail::parallel_for(executor, n, [&](std::size_t i, std::size_t last) {
+		for (; i < last; ++i) {
+			first[i].reset();
+		}
+	});
+}
+
+template <class Range>
+inline void parallel_destroy(Range& range) {
+	parallel_destroy(range, default_pool());
+}
+
+} // namespace pl
@@ -0,0 +1,310 @@
+#pragma once
+#include <algorithm> // max, min
+#include <array>     // array
+#include <iterator>  // begin, end, distance, iterator_traits
+#include <utility>   // move, swap
+#include "parallel_algorithm.hpp"
+
+namespace pl {
+namespace detail {
+
+// class type_buckets ==========================================================
+
+template<class It>
+inline type_buckets<It>::type_buckets(It first, std::size_t n) {
+	// Consecutive objects are likely to have the same type
+	std::size_t last_bucket = 0;
+
+	for (std::size_t i = 0; i < n; ++i) {
+		if (!first[i]) continue;
+		const std::type_info& type = typeid(*first[i]);
+
+		if (buckets.empty() || *buckets[last_bucket].type != type) {
+			last_bucket = 0;
+			while (last_bucket < buckets.size() && *buckets[last_bucket].type != type) {
+				++last_bucket;
+			}
+			if (last_bucket == buckets.size()) {
+				buckets.push_back(bucket{&type, std::vector<std::size_t>()});
+			}
+		}
+
+		buckets[last_bucket].indices.push_back(i);
+	}
+}
+
+// chunk_plan ==================================================================
+
+// Calls visitor for objects at positions [idx_first, idx_last), all of
+// which have the dynamic type T (or any type, if T is the base)
+template <class Base, class T, class It, class Visitor>
+inline void visit_chunk(It first, const std::size_t* idx_first,
+	const std::size_t* idx_last, std::size_t chunk, Visitor& visitor) {
+	for (; idx_first != idx_last; ++idx_first) {
+		Base* obj = first[*idx_first].get();
+		visitor(chunk, *idx_first, *inheritance_traits<Base, T>::downcast(obj));
+	}
+}
+
+template <class Base, class It, class Visitor, class List>
+struct chunk_visitors;
+
+template <class Base, class It, class Visitor, class... Ts>
+struct chunk_visitors<Base, It, Visitor, type_list<Ts...>> {
+	using visit = void(*)(It, const std::size_t*, const std::size_t*,
+		std::size_t, Visitor&);
+
+	// One function per type in the list, and one for the base at the end
+	static const std::array<visit, sizeof...(Ts) + 1>& get() {
+		static const std::array<visit, sizeof...(Ts) + 1> rslt = {{
+			&visit_chunk<Base, same_const<Base, Ts>, It, Visitor>...,
+			&visit_chunk<Base, Base, It, Visitor>}};
+		return rslt;
+	}
+};
+
+template <class List, class Executor, class It>
+inline chunk_plan<It> plan_chunks(Executor& executor, It first, std::size_t n) {
+	chunk_plan<It> rslt{type_buckets<It>(first, n), {}};
+
+	std::size_t threads = static_cast<std::size_t>(concurrency(executor, 0));
+	std::size_t chunk_size = std::max<std::size_t>(1, n / (std::max<std::size_t>(1, threads) * 4));
+
+	for (auto&& b : rslt.buckets.buckets) {
+		std::size_t type = type_indices<List>::of(*first[b.indices.front()]);
+
+		const std::size_t* data = b.indices.data();
+		for (std::size_t i = 0; i < b.indices.size(); i += chunk_size) {
+			std::size_t last = std::min(b.indices.size(), i + chunk_size);
+			rslt.chunks.push_back({type, data + i, data + last});
+		}
+	}
+
+	return rslt;
+}
+
+template <class List, class Executor, class It, class Visitor>
+inline void visit_chunks(Executor& executor, It first, const chunk_plan<It>& plan,
+	Visitor& visitor) {
+	using poly_type = typename std::iterator_traits<It>::value_type;
+	using visitors = chunk_visitors<typename poly_type::base_type, It, Visitor, List>;
+
+	parallel_for(executor, plan.chunks.size(), [&](std::size_t i, std::size_t last) {
+		for (; i < last; ++i) {
+			auto& c = plan.chunks[i];
+			visitors::get()[c.type](first, c.first, c.last, i, visitor);
+		}
+	});
+}
+
+// Visitors ====================================================================
+
+template <class F>
+struct for_each_visitor {
+	F& f;
+
+	template <class T>
+	void operator()(std::size_t, std::size_t, T& obj) {
+		f(obj);
+	}
+};
+
+// Reduces every chunk into partials[chunk], starting from its first object
+template <class T, class Reduce, class Transform>
+struct reduce_visitor {
+	Reduce& reduce;
+	Transform& transform;
+	std::vector<T>& partials;
+	std::vector<char>& started;
+
+	template <class U>
+	void operator()(std::size_t chunk, std::size_t, U& obj) {
+		if (started[chunk]) {
+			partials[chunk] = reduce(std::move(partials[chunk]), transform(obj));
+		}
+		else {
+			partials[chunk] = transform(obj);
+			started[chunk] = true;
+		}
+	}
+};
+
+template <class Pred>
+struct predicate_visitor {
+	Pred& pred;
+	std::vector<char>& flags;
+
+	template <class T>
+	void operator()(std::size_t, std::size_t index, T& obj) {
+		flags[index] = static_cast<bool>(pred(obj));
+	}
+};
+
+// Evaluates pred for every object in parallel. Empty polys get false.
+template <class List, class Executor, class It, class Pred>
+inline std::vector<char> evaluate(Executor& executor, It first, std::size_t n,
+	Pred& pred) {
+	std::vector<char> flags(n, false);
+	predicate_visitor<Pred> visitor{pred, flags};
+	visit_chunks<List>(executor, first, plan_chunks<List>(executor, first, n), visitor);
+
+	return flags;
+}
+
+} // namespace detail
+
+namespace par {
+
+// for_each ====================================================================
+
+template <class Range, class F>
+inline void for_each(Range& range, F f) {
+	for_each<type_list<>>(range, f, default_pool());
+}
+
+template <class Range, class F, class Executor>
+inline void for_each(Range& range, F f, Executor& executor) {
+	for_each<type_list<>>(range, f, executor);
+}
+
+template <class List, class Range, class Handlers>
+inline void for_each(Range& range, Handlers handlers) {
+	for_each<List>(range, handlers, default_pool());
+}
+
+template <class List, class Range, class Handlers, class Executor>
+inline void for_each(Range& range, Handlers handlers, Executor& executor) {
+	auto first = std::begin(range);
+	std::size_t n = static_cast<std::size_t>(std::distance(first, std::end(range)));
+
+	detail::for_each_visitor<Handlers> visitor{handlers};
+	detail::visit_chunks<List>(executor, first,
+		detail::plan_chunks<List>(executor, first, n), visitor);
+}
+
+// transform_reduce ============================================================
+
+template <class Range, class T, class Reduce, class Transform>
+inline T transform_reduce(Range& range, T init, Reduce reduce, Transform transform) {
+	return transform_reduce<type_list<>>(range, std::move(init), reduce, transform, default_pool());
+}
+
+template <class Range, class T, class Reduce, class Transform, class Executor>
+inline T transform_reduce(Range& range, T init, Reduce reduce, Transform transform,
+	Executor& executor) {
+	return transform_reduce<type_list<>>(range, std::move(init), reduce, transform, executor);
+}
+
+template <class List, class Range, class T, class Reduce, class Transform>
+inline T transform_reduce(Range& range, T init, Reduce reduce, Transform transform) {
+	return transform_reduce<List>(range, std::move(init), reduce, transform, default_pool());
+}
+
+template <class List, class Range, class T, class Reduce, class Transform,
+	class Executor>
+inline T transform_reduce(Range& range, T init, Reduce reduce, Transform transform,
+	Executor& executor) {
+	auto first = std::begin(range);
+	std::size_t n = static_cast<std::size_t>(std::distance(first, std::end(range)));
+
+	auto plan = detail::plan_chunks<List>(executor, first, n);
+
+	// Chunks are never empty, so every partial is overwritten
+	std::vector<T> partials(plan.chunks.size(), init);
+	std::vector<char> started(plan.chunks.size(), false);
+
+	detail::reduce_visitor<T, Reduce, Transform> visitor{reduce, transform, partials, started};
+	detail::visit_chunks<List>(executor, first, plan, visitor);
+
+	for (auto&& partial : partials) {
+		init = reduce(std::move(init), std::move(partial));
+	}
+	return init;
+}
+
+// partition ===================================================================
+
+template <class Range, class Pred>
+inline auto partition(Range& range, Pred pred) -> decltype(std::begin(range)) {
+	return partition<type_list<>>(range, pred, default_pool());
+}
+
+template <class Range, class Pred, class Executor>
+inline auto partition(Range& range, Pred pred, Executor& executor)
+-> decltype(std::begin(range)) {
+	return partition<type_list<>>(range, pred, executor);
+}
+
+template <class List, class Range, class Pred>
+inline auto partition(Range& range, Pred pred) -> decltype(std::begin(range)) {
+	return partition<List>(range, pred, default_pool());
+}
+
+template <class List, class Range, class Pred, class Executor>
+inline auto partition(Range& range, Pred pred, Executor& executor)
+-> decltype(std::begin(range)) {
+	auto first = std::begin(range);
+	std::size_t n = static_cast<std::size_t>(std::distance(first, std::end(range)));
+
+	std::vector<char> flags = detail::evaluate<List>(executor, first, n, pred);
+
+	// Hoare partition, swapping flags along with polys
+	std::size_t i = 0;
+	std::size_t j = n;
+	while (true) {
+		while (i < j && flags[i]) ++i;
+		while (i < j && !flags[j - 1]) --j;
+		if (i >= j) break;
+
+		using std::swap;
+		swap(first[i], first[j - 1]);
+		swap(flags[i], flags[j - 1]);
+	}
+
+	return first + i;
+}
+
+template <class Range, class Pred>
+inline auto stable_partition(Range& range, Pred pred) -> decltype(std::begin(range)) {
+	return stable_partition<type_list<>>(range, pred, default_pool());
+}
+
+template <class Range, class Pred, class Executor>
+inline auto stable_partition(Range& range, Pred pred, Executor& executor)
+-> decltype(std::begin(range)) {
+	return stable_partition<type_list<>>(range, pred, executor);
+}
+
+template <class List, class Range, class Pred>
+inline auto stable_partition(Range& range, Pred pred) -> decltype(std::begin(range)) {
+	return stable_partition<List>(range, pred, default_pool());
+}
+
+template <class List, class Range, class Pred, class Executor>
+inline auto stable_partition(Range& range, Pred pred, Executor& executor)
+-> decltype(std::begin(range)) {
+	using poly_type = typename std::iterator_traits<decltype(std::begin(range))>::value_type;
+
+	auto first = std::begin(range);
+	std::size_t n = static_cast<std::size_t>(std::distance(first, std::end(range)));
+
+	std::vector<char> flags = detail::evaluate<List>(executor, first, n, pred);
+
+	std::vector<poly_type> rejected;
+	std::size_t kept = 0;
+	for (std::size_t i = 0; i < n; ++i) {
+		if (flags[i]) {
+			if (kept != i) first[kept] = std::move(first[i]);
+			++kept;
+		}
+		else {
+			rejected.push_back(std::move(first[i]));
+		}
+	}
+	std::move(rejected.begin(), rejected.end(), first + kept);
+
+	return first + kept;
+}
+
+} // namespace par
+} // namespace pl
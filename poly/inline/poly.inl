@@ -18,12 +18,14 @@ inline poly<Base, CopyDeletePolicy>::poly(const poly& other) :
 	policy(other),
 	data(nullptr) {
 	if (other) data = this->clone(other.get());
+	adopt();
 }
 
 template<class Base, class CopyDeletePolicy>
 inline poly<Base, CopyDeletePolicy>::poly(poly&& other) noexcept :
 	policy(std::move(static_cast<policy&>(other))),
 	data(other.release()) {
+	adopt();
 }
 
 template<class Base, class CopyDeletePolicy>
@@ -33,6 +35,7 @@ poly<Base, CopyDeletePolicy>::operator=(const poly& other) {
 
 	reset();
 	if (other) data = this->clone(other.get());
+	adopt();
 	
 	return *this;
 }
@@ -44,6 +47,7 @@ poly<Base, CopyDeletePolicy>::operator=(poly&& other) noexcept {
 
 	reset();
 	data = other.release();
+	adopt();
 
 	return *this;
 }
@@ -58,6 +62,7 @@ inline constexpr poly<Base, CopyDeletePolicy>::poly(std::nullptr_t) noexcept :
 template<class Base, class CopyDeletePolicy>
 inline poly<Base, CopyDeletePolicy>& 
 poly<Base, CopyDeletePolicy>::operator=(std::nullptr_t) noexcept {
+	forget();
 	data = nullptr;
 
 	return *this;
@@ -75,6 +80,7 @@ poly(const poly<Base2, CopyDeletePolicy2>& other) :
 		"poly: Base is not polymorphic, poly is useless. Consider using std::unique_ptr instead.");
 
 	if (other) data = this->clone(other.get());
+	adopt();
 }
 
 template<class Base, class CopyDeletePolicy>
@@ -85,6 +91,8 @@ poly(poly<Base2, CopyDeletePolicy2>&& other) noexcept :
 	data(other.release()) {
 	static_assert(std::is_polymorphic<Base>::value,
 		"poly: Base is not polymorphic, poly is useless. Consider using std::unique_ptr instead.");
+
+	adopt();
 }
 
 // From a pointer ----------------------------------------------------------
@@ -92,25 +100,28 @@ poly(poly<Base2, CopyDeletePolicy2>&& other) noexcept :
 template<class Base, class CopyDeletePolicy>
 template<class Derived>
 inline poly<Base, CopyDeletePolicy>::poly(Derived* obj) :
-	policy(obj),
-	data(obj) {
-	static_assert(std::is_polymorphic<Base>::value,
-		"poly: Base is not polymorphic, poly is useless. Consider using std::unique_ptr instead.");
-	static_assert(std::is_base_of<Base, Derived>::value,
-		"poly: poly can only be built using types, derived from Base");
-	if (typeid(*obj) != typeid(Derived))
-		throw std::runtime_error(
-			std::string("poly: passed pointer of type '") +
-			POLY_TYPE_NAME(Derived) +
-			"' must not point to a polymorphic object");
-
-	detail::inheritance_traits<Base, Derived>::set_offset(get(), obj);
+	poly(detail::created_t(), obj) {
+	static_assert(!detail::has_create<policy>::value,
+		"poly: policy makes its objects itself, use make instead of new");
 }
 
 template<class Base, class CopyDeletePolicy>
 template<class Derived>
 inline poly<Base, CopyDeletePolicy>& 
 poly<Base, CopyDeletePolicy>::operator=(Derived* obj) {
+	static_assert(!detail::has_create<policy>::value,
+		"poly: policy makes its objects itself, use make instead of new");
+	reset(obj);
+	return *this;
+}
+
+template<class Base, class CopyDeletePolicy>
+template<class Derived>
+inline poly<Base, CopyDeletePolicy>::poly(detail::created_t, Derived* obj) :
+	policy(obj),
+	data(obj) {
+	static_assert(std::is_polymorphic<Base>::value,
+		"poly: Base is not polymorphic, poly is useless. Consider using std::unique_ptr instead.");
 	static_assert(std::is_base_of<Base, Derived>::value,
 		"poly: poly can only be built using types, derived from Base");
 	if (typeid(*obj) != typeid(Derived))
@@ -119,8 +130,8 @@ poly<Base, CopyDeletePolicy>::operator=(Derived* obj) {
 			POLY_TYPE_NAME(Derived) +
 			"' must not point to a polymorphic object");
 
-	reset(obj);
 	detail::inheritance_traits<Base, Derived>::set_offset(get(), obj);
+	adopt();
 }
 
 // Destruction -------------------------------------------------------------
@@ -146,6 +157,7 @@ constexpr poly<Base, CopyDeletePolicy>::operator bool() const noexcept {
 template<class Base, class CopyDeletePolicy>
 inline Base* poly<Base, CopyDeletePolicy>::release() noexcept {
 	Base* rslt = data;
+	forget();
 	data = nullptr;
 
 	return rslt;
@@ -162,6 +174,8 @@ inline void poly<Base, CopyDeletePolicy>::reset(std::nullptr_t) noexcept {
 template<class Base, class CopyDeletePolicy>
 template<class Derived>
 inline void poly<Base, CopyDeletePolicy>::reset(Derived* obj) {
+	static_assert(!detail::has_create<policy>::value,
+		"poly: policy makes its objects itself, use make instead of new");
 	static_assert(std::is_base_of<Base, Derived>::value,
 		"poly: poly can only be built using types, derived from Base");
 	if (typeid(*obj) != typeid(Derived))
@@ -173,6 +187,7 @@ inline void poly<Base, CopyDeletePolicy>::reset(Derived* obj) {
 	if (data) this->destroy(data);
 	data = obj;
 	detail::inheritance_traits<Base, Derived>::set_offset(get(), obj);
+	adopt();
 }
 
 template<class Base, class CopyDeletePolicy>
@@ -190,6 +205,16 @@ inline Base* poly<Base, CopyDeletePolicy>::get() const noexcept {
 	return data;
 }
 
+template<class Base, class CopyDeletePolicy>
+inline void poly<Base, CopyDeletePolicy>::adopt() noexcept {
+	detail::policy_adopt(static_cast<policy&>(*this), data, 0);
+}
+
+template<class Base, class CopyDeletePolicy>
+inline void poly<Base, CopyDeletePolicy>::forget() noexcept {
+	detail::policy_forget(static_cast<policy&>(*this), data, 0);
+}
+
 // Member access ===========================================================
 
 template<class Base, class CopyDeletePolicy>
@@ -204,30 +229,166 @@ T* poly<Base, CopyDeletePolicy>::as() const noexcept {
 	return nullptr;
 }
 
+template<class Base, class CopyDeletePolicy>
+template<class T>
+T* poly<Base, CopyDeletePolicy>::as_base() const {
+	static_assert(detail::is_more_cv<T, Base>::value,
+		"poly: cannot cast away qualifiers of Base");
+
+	return detail::cast_table<
+		typename std::remove_cv<Base>::type,
+		typename std::remove_cv<T>::type>::cast(get());
+}
+
 // Non-member functions ========================================================
 
+namespace detail {
+
+// Makes Derived with the policy's create, if it has one, or with new
+template<class Policy, class Derived, class... Args>
+inline auto policy_create(int, Args&&... args)
+->decltype(Policy::template create<Derived>(std::forward<Args>(args)...)) {
+	return Policy::template create<Derived>(std::forward<Args>(args)...);
+}
+
+template<class Policy, class Derived, class... Args>
+inline Derived* policy_create(long, Args&&... args) {
+	return new Derived(std::forward<Args>(args)...);
+}
+
+template<class Policy, class T>
+inline auto policy_adopt(Policy& policy, T*& data, int) noexcept
+-> decltype(policy.adopt(data)) {
+	return policy.adopt(data);
+}
+
+template<class Policy, class T>
+inline void policy_adopt(Policy&, T*&, long) noexcept {
+}
+
+template<class Policy, class T>
+inline auto policy_forget(Policy& policy, T* data, int) noexcept
+-> decltype(policy.forget(data)) {
+	return policy.forget(data);
+}
+
+template<class Policy, class T>
+inline void policy_forget(Policy&, T*, long) noexcept {
+}
+
+template<class PolyType, class Derived>
+inline PolyType from_created(Derived* obj) {
+	return PolyType(created_t(), obj);
+}
+
+struct policy_probe {};
+
+template <class Policy>
+struct has_create_impl {
+	template <class P>
+	static auto test(int) -> decltype(
+		P::template create<policy_probe>(), std::true_type());
+
+	template <class>
+	static std::false_type test(...);
+
+	using type = decltype(test<Policy>(0));
+};
+
+template <class T1, class T2>
+struct same_template : std::is_same<T1, T2> {
+};
+
+template <template <class...> class T, class... Args1, class... Args2>
+struct same_template<T<Args1...>, T<Args2...>> : std::true_type {
+};
+
+/// The deleter of a compound policy, or the policy itself
+template <class Policy>
+struct deleter_of {
+	using type = Policy;
+};
+
+template <class Cloner, class Deleter>
+struct deleter_of<compound<Cloner, Deleter>> {
+	using type = Deleter;
+};
+
+template <class Policy1, class Policy2>
+struct same_deleter : same_template<
+	typename deleter_of<Policy1>::type,
+	typename deleter_of<Policy2>::type> {
+};
+
+} // namespace detail
+
 template<class PolyType, class Derived, class... Args>
 PolyType make(Args&&... args) {
-	return PolyType(new Derived(std::forward<Args>(args)...));
+	return detail::from_created<PolyType>(
+		detail::policy_create<typename PolyType::policy, Derived>(
+		0, std::forward<Args>(args)...));
 }
 
 template<class PolyType, class Derived, class OldBase, class CopyDeletePolicy>
 PolyType transform(const poly<OldBase, CopyDeletePolicy>& other) {
 	if (other) {
-		return PolyType(
-			new Derived(*other.template as<Derived>()));
+		return make<PolyType, Derived>(*other.template as<Derived>());
 	}
 	return PolyType();
 }
 
+namespace detail {
+
+// Moves the object of other into a new allocation
 template<class PolyType, class Derived, class OldBase, class CopyDeletePolicy>
-PolyType transform(poly<OldBase, CopyDeletePolicy>&& other) {
+PolyType transform(poly<OldBase, CopyDeletePolicy>&& other, std::true_type) {
+	if (!other) return PolyType();
+
+	PolyType rslt = make<PolyType, Derived>(std::move(*other.template as<Derived>()));
+	other.reset();
+	return rslt;
+}
+
+// Adopts the object of other
+template<class PolyType, class Derived, class OldBase, class CopyDeletePolicy>
+PolyType transform(poly<OldBase, CopyDeletePolicy>&& other, std::false_type) {
 	Derived* temp = other.template as<Derived>();
 	other.release();
 	
 	return PolyType(temp);
 }
 
+} // namespace detail
+
+template<class PolyType, class Derived, class OldBase, class CopyDeletePolicy>
+PolyType transform(poly<OldBase, CopyDeletePolicy>&& other) {
+	// Policies with their own allocation can't adopt each other's objects
+	return detail::transform<PolyType, Derived>(std::move(other),
+		std::integral_constant<bool,
+		detail::has_create<CopyDeletePolicy>::value ||
+		detail::has_create<typename PolyType::policy>::value>());
+}
+
+template<class PolyType, class OldBase, class CopyDeletePolicy>
+PolyType cast(poly<OldBase, CopyDeletePolicy>&& other) {
+	static_assert(std::is_empty<typename PolyType::policy>::value,
+		"cast: target policy must not store anything about the object's type, as deep does");
+	static_assert(!detail::has_create<CopyDeletePolicy>::value &&
+		!detail::has_create<typename PolyType::policy>::value,
+		"cast: policies with their own allocation can't adopt each other's objects");
+	static_assert(detail::same_deleter<CopyDeletePolicy, typename PolyType::policy>::value,
+		"cast: target policy must free objects with the same deleter as the source policy");
+
+	PolyType rslt;
+	rslt.data = other.template as_base<typename PolyType::base_type>();
+	if (rslt.data) {
+		other.release();
+		rslt.adopt();
+	}
+
+	return rslt;
+}
+
 // Comparison operators ========================================================
 template<class B1, class C1, class B2, class C2>
 	bool operator==(const poly<B1, C1>& x, const poly<B2, C2>& y) {
@@ -0,0 +1,66 @@
+#pragma once
+#include <thread>  // this_thread
+#include <utility> // move
+#include "poly_queue.hpp"
+
+namespace pl {
+
+template <class Base, class CopyDeletePolicy, class Concurrency>
+inline poly_queue<Base, CopyDeletePolicy, Concurrency>::poly_queue(std::size_t capacity) :
+	queue(capacity) {
+}
+
+// Non-blocking ================================================================
+
+template <class Base, class CopyDeletePolicy, class Concurrency>
+inline bool poly_queue<Base, CopyDeletePolicy, Concurrency>::try_push(value_type& value) noexcept {
+	return queue.try_push(value);
+}
+
+template <class Base, class CopyDeletePolicy, class Concurrency>
+inline bool poly_queue<Base, CopyDeletePolicy, Concurrency>::try_pop(value_type& value) noexcept {
+	return queue.try_pop(value);
+}
+
+template <class Base, class CopyDeletePolicy, class Concurrency>
+template <class It>
+inline It poly_queue<Base, CopyDeletePolicy, Concurrency>::try_push(It first, It last) noexcept {
+	return queue.try_push(first, last);
+}
+
+template <class Base, class CopyDeletePolicy, class Concurrency>
+template <class OutputIt>
+inline std::size_t
+poly_queue<Base, CopyDeletePolicy, Concurrency>::try_pop(OutputIt out, std::size_t max) {
+	return queue.try_pop(out, max);
+}
+
+// Blocking ====================================================================
+
+template <class Base, class CopyDeletePolicy, class Concurrency>
+inline void poly_queue<Base, CopyDeletePolicy, Concurrency>::push(value_type value) noexcept {
+	while (!queue.try_push(value)) std::this_thread::yield();
+}
+
+template <class Base, class CopyDeletePolicy, class Concurrency>
+inline typename poly_queue<Base, CopyDeletePolicy, Concurrency>::value_type
+poly_queue<Base, CopyDeletePolicy, Concurrency>::pop() noexcept {
+	value_type rslt;
+	while (!queue.try_pop(rslt)) std::this_thread::yield();
+	return rslt;
+}
+
+template <class Base, class CopyDeletePolicy, class Concurrency>
+template <class It>
+inline void poly_queue<Base, CopyDeletePolicy, Concurrency>::push(It first, It last) noexcept {
+	while ((first = queue.try_push(first, last)) != last) std::this_thread::yield();
+}
+
+// Observers ===================================================================
+
+template <class Base, class CopyDeletePolicy, class Concurrency>
+inline std::size_t poly_queue<Base, CopyDeletePolicy, Concurrency>::capacity() const noexcept {
+	return queue.capacity();
+}
+
+} // namespace pl
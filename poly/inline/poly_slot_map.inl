@@ -0,0 +1,211 @@
+#pragma once
+#include <stdexcept> // length_error, out_of_range
+#include <utility>   // forward, move
+#include "poly_slot_map.hpp"
+
+namespace pl {
+
+template <class Base, class CopyDeletePolicy>
+constexpr typename poly_slot_map<Base, CopyDeletePolicy>::handle
+poly_slot_map<Base, CopyDeletePolicy>::null_handle;
+
+template <class Base, class CopyDeletePolicy>
+constexpr std::uint32_t poly_slot_map<Base, CopyDeletePolicy>::no_slot;
+
+// Construction ================================================================
+
+template <class Base, class CopyDeletePolicy>
+inline poly_slot_map<Base, CopyDeletePolicy>::poly_slot_map() :
+	free_head(no_slot) {
+}
+
+// Iterators ===================================================================
+
+template <class Base, class CopyDeletePolicy>
+inline typename poly_slot_map<Base, CopyDeletePolicy>::iterator
+poly_slot_map<Base, CopyDeletePolicy>::begin() noexcept {
+	return values.begin();
+}
+
+template <class Base, class CopyDeletePolicy>
+inline typename poly_slot_map<Base, CopyDeletePolicy>::const_iterator
+poly_slot_map<Base, CopyDeletePolicy>::begin() const noexcept {
+	return values.begin();
+}
+
+template <class Base, class CopyDeletePolicy>
+inline typename poly_slot_map<Base, CopyDeletePolicy>::iterator
+poly_slot_map<Base, CopyDeletePolicy>::end() noexcept {
+	return values.end();
+}
+
+template <class Base, class CopyDeletePolicy>
+inline typename poly_slot_map<Base, CopyDeletePolicy>::const_iterator
+poly_slot_map<Base, CopyDeletePolicy>::end() const noexcept {
+	return values.end();
+}
+
+// Capacity ====================================================================
+
+template <class Base, class CopyDeletePolicy>
+inline bool poly_slot_map<Base, CopyDeletePolicy>::empty() const noexcept {
+	return values.empty();
+}
+
+template <class Base, class CopyDeletePolicy>
+inline typename poly_slot_map<Base, CopyDeletePolicy>::size_type
+poly_slot_map<Base, CopyDeletePolicy>::size() const noexcept {
+	return values.size();
+}
+
+template <class Base, class CopyDeletePolicy>
+inline void poly_slot_map<Base, CopyDeletePolicy>::reserve(size_type new_capacity) {
+	values.reserve(new_capacity);
+	owners.reserve(new_capacity);
+	slots.reserve(new_capacity);
+}
+
+// Lookup ======================================================================
+
+template <class Base, class CopyDeletePolicy>
+inline bool poly_slot_map<Base, CopyDeletePolicy>::contains(handle h) const noexcept {
+	return live_slot(h) != nullptr;
+}
+
+template <class Base, class CopyDeletePolicy>
+inline typename poly_slot_map<Base, CopyDeletePolicy>::value_type*
+poly_slot_map<Base, CopyDeletePolicy>::find(handle h) noexcept {
+	const slot* s = live_slot(h);
+	return s ? &values[s->index] : nullptr;
+}
+
+template <class Base, class CopyDeletePolicy>
+inline const typename poly_slot_map<Base, CopyDeletePolicy>::value_type*
+poly_slot_map<Base, CopyDeletePolicy>::find(handle h) const noexcept {
+	const slot* s = live_slot(h);
+	return s ? &values[s->index] : nullptr;
+}
+
+template <class Base, class CopyDeletePolicy>
+inline typename poly_slot_map<Base, CopyDeletePolicy>::value_type&
+poly_slot_map<Base, CopyDeletePolicy>::at(handle h) {
+	value_type* rslt = find(h);
+	if (!rslt) throw std::out_of_range("poly_slot_map: stale handle");
+	return *rslt;
+}
+
+template <class Base, class CopyDeletePolicy>
+inline const typename poly_slot_map<Base, CopyDeletePolicy>::value_type&
+poly_slot_map<Base, CopyDeletePolicy>::at(handle h) const {
+	const value_type* rslt = find(h);
+	if (!rslt) throw std::out_of_range("poly_slot_map: stale handle");
+	return *rslt;
+}
+
+template <class Base, class CopyDeletePolicy>
+template <class T>
+inline T* poly_slot_map<Base, CopyDeletePolicy>::get(handle h) const noexcept {
+	const value_type* p = find(h);
+	return p ? p->template as<T>() : nullptr;
+}
+
+template <class Base, class CopyDeletePolicy>
+inline typename poly_slot_map<Base, CopyDeletePolicy>::handle
+poly_slot_map<Base, CopyDeletePolicy>::handle_of(size_type i) const {
+	std::uint32_t s = owners[i];
+	return make_handle(s, slots[s].generation);
+}
+
+// Modifiers ===================================================================
+
+template <class Base, class CopyDeletePolicy>
+inline typename poly_slot_map<Base, CopyDeletePolicy>::handle
+poly_slot_map<Base, CopyDeletePolicy>::insert(value_type value) {
+	// A new slot is added to the free list, so that it can be reused if the
+	// poly can't be inserted
+	if (free_head == no_slot) {
+		if (slots.size() == no_slot) {
+			throw std::length_error("poly_slot_map: too many slots");
+		}
+		slots.push_back(slot{no_slot, 0});
+		free_head = static_cast<std::uint32_t>(slots.size() - 1);
+	}
+
+	owners.push_back(free_head);
+	try {
+		values.push_back(std::move(value));
+	}
+	catch (...) {
+		owners.pop_back();
+		throw;
+	}
+
+	std::uint32_t s = free_head;
+	free_head = slots[s].index;
+	slots[s].index = static_cast<std::uint32_t>(values.size() - 1);
+	++slots[s].generation;
+
+	return make_handle(s, slots[s].generation);
+}
+
+template <class Base, class CopyDeletePolicy>
+template <class Derived, class... Args>
+inline typename poly_slot_map<Base, CopyDeletePolicy>::handle
+poly_slot_map<Base, CopyDeletePolicy>::emplace(Args&&... args) {
+	return insert(make<value_type, Derived>(std::forward<Args>(args)...));
+}
+
+template <class Base, class CopyDeletePolicy>
+inline bool poly_slot_map<Base, CopyDeletePolicy>::erase(handle h) {
+	const slot* live = live_slot(h);
+	if (!live) return false;
+
+	std::uint32_t s = static_cast<std::uint32_t>(h);
+	std::uint32_t i = live->index;
+
+	// The last poly takes the place of the erased one
+	if (i + 1 != values.size()) {
+		values[i] = std::move(values.back());
+		owners[i] = owners.back();
+		slots[owners[i]].index = i;
+	}
+	values.pop_back();
+	owners.pop_back();
+	release(s);
+
+	return true;
+}
+
+template <class Base, class CopyDeletePolicy>
+inline void poly_slot_map<Base, CopyDeletePolicy>::clear() noexcept {
+	for (std::uint32_t s : owners) release(s);
+	values.clear();
+	owners.clear();
+}
+
+template <class Base, class CopyDeletePolicy>
+inline typename poly_slot_map<Base, CopyDeletePolicy>::handle
+poly_slot_map<Base, CopyDeletePolicy>::make_handle(
+	std::uint32_t index, std::uint32_t generation) noexcept {
+	return static_cast<handle>(generation) << 32 | index;
+}
+
+template <class Base, class CopyDeletePolicy>
+inline const typename poly_slot_map<Base, CopyDeletePolicy>::slot*
+poly_slot_map<Base, CopyDeletePolicy>::live_slot(handle h) const noexcept {
+	std::uint32_t index = static_cast<std::uint32_t>(h);
+	std::uint32_t generation = static_cast<std::uint32_t>(h >> 32);
+
+	if (index >= slots.size()) return nullptr;
+	const slot& s = slots[index];
+	return s.generation == generation && generation % 2 == 1 ? &s : nullptr;
+}
+
+template <class Base, class CopyDeletePolicy>
+inline void poly_slot_map<Base, CopyDeletePolicy>::release(std::uint32_t s) noexcept {
+	++slots[s].generation;
+	slots[s].index = free_head;
+	free_head = s;
+}
+
+} // namespace pl
@@ -0,0 +1,268 @@
+#pragma once
+#include <new>         // operator new, placement new
+#include <stdexcept>   // runtime_error
+#include <string>      // string
+#include <type_traits> // has_virtual_destructor, is_copy_constructible
+#include <utility>     // forward
+#include "recycling_policies.hpp"
+#include "inheritance_traits.hpp"
+
+namespace pl {
+
+// recycling_statistics ========================================================
+
+inline double recycling_statistics::hit_rate() const noexcept {
+	std::uint64_t total = hits + misses;
+	return total == 0 ? 0 : static_cast<double>(hits) / total;
+}
+
+inline recycling_statistics recycling_stats() noexcept {
+	return detail::slab_recycler::instance().statistics();
+}
+
+namespace detail {
+
+// class slab_recycler =========================================================
+
+inline slab_recycler::slab_recycler() noexcept :
+	caches(nullptr) {
+}
+
+inline slab_recycler& slab_recycler::instance() {
+	static slab_recycler* rslt = new slab_recycler;
+	return *rslt;
+}
+
+inline void* slab_recycler::allocate(std::size_t size) {
+	std::size_t block_size = sizeof(header) + (size + granularity - 1) / granularity * granularity;
+	cache* c = local();
+
+	header* h;
+	if (block_size > max_block_size) {
+		h = static_cast<header*>(::operator new(block_size));
+		h->owner = nullptr;
+		h->size_class = class_count;
+		increment(c->misses);
+	}
+	else {
+		std::size_t size_class = block_size / granularity - 1;
+		node*& list = c->free_lists[size_class];
+		if (!list) drain(c);
+
+		if (list) {
+			increment(c->hits);
+		}
+		else {
+			refill(c, size_class);
+			increment(c->misses);
+		}
+
+		node* n = list;
+		list = n->next;
+		h = &n->h;
+	}
+
+	return h + 1;
+}
+
+inline void slab_recycler::deallocate(void* ptr) noexcept {
+	if (!ptr) return;
+
+	node* n = reinterpret_cast<node*>(static_cast<header*>(ptr) - 1);
+	cache* owner = n->h.owner;
+	if (!owner) {
+		::operator delete(n);
+		return;
+	}
+
+	if (owner == thread_cache()) {
+		n->next = owner->free_lists[n->h.size_class];
+		owner->free_lists[n->h.size_class] = n;
+		return;
+	}
+
+	// Only the owner takes blocks from its remote list, all at once, so
+	// there is no ABA problem
+	n->next = owner->remote.load(std::memory_order_relaxed);
+	while (!owner->remote.compare_exchange_weak(n->next, n,
+		std::memory_order_release, std::memory_order_relaxed)) {
+	}
+	owner->remote_frees.fetch_add(1, std::memory_order_relaxed);
+}
+
+inline recycling_statistics slab_recycler::statistics() const noexcept {
+	recycling_statistics rslt{0, 0, 0};
+	for (cache* c = caches.load(std::memory_order_acquire); c; c = c->next) {
+		rslt.hits += c->hits.load(std::memory_order_relaxed);
+		rslt.misses += c->misses.load(std::memory_order_relaxed);
+		rslt.remote_frees += c->remote_frees.load(std::memory_order_relaxed);
+	}
+	return rslt;
+}
+
+inline slab_recycler::cache*& slab_recycler::thread_cache() noexcept {
+	// Releases the cache when the thread exits. Blocks, freed on this thread
+	// after that, are pushed to the remote list.
+	struct owner {
+		cache* c;
+		~owner() {
+			if (c) c->in_use.store(false, std::memory_order_release);
+			c = nullptr;
+		}
+	};
+
+	static thread_local owner rslt{nullptr};
+	return rslt.c;
+}
+
+inline slab_recycler::cache* slab_recycler::local() {
+	cache*& rslt = thread_cache();
+	if (rslt == nullptr) rslt = acquire();
+	return rslt;
+}
+
+inline slab_recycler::cache* slab_recycler::acquire() {
+	for (cache* c = caches.load(std::memory_order_acquire); c; c = c->next) {
+		bool expected = false;
+		if (!c->in_use.load(std::memory_order_relaxed) &&
+			c->in_use.compare_exchange_strong(expected, true, std::memory_order_acquire)) {
+			return c;
+		}
+	}
+
+	cache* c = new cache;
+	for (node*& list : c->free_lists) list = nullptr;
+	c->remote.store(nullptr, std::memory_order_relaxed);
+	c->in_use.store(true, std::memory_order_relaxed);
+	c->hits.store(0, std::memory_order_relaxed);
+	c->misses.store(0, std::memory_order_relaxed);
+	c->remote_frees.store(0, std::memory_order_relaxed);
+	c->next = caches.load(std::memory_order_relaxed);
+	while (!caches.compare_exchange_weak(c->next, c, std::memory_order_release)) {
+	}
+	return c;
+}
+
+inline void slab_recycler::drain(cache* c) noexcept {
+	node* n = c->remote.exchange(nullptr, std::memory_order_acquire);
+	while (n) {
+		node* next = n->next;
+		n->next = c->free_lists[n->h.size_class];
+		c->free_lists[n->h.size_class] = n;
+		n = next;
+	}
+}
+
+inline void slab_recycler::refill(cache* c, std::size_t size_class) {
+	std::size_t block_size = (size_class + 1) * granularity;
+	unsigned char* slab = static_cast<unsigned char*>(::operator new(slab_size));
+
+	// Carved from the end, so that blocks are handed out in address order
+	node* list = c->free_lists[size_class];
+	for (std::size_t pos = slab_size / block_size * block_size; pos != 0;) {
+		pos -= block_size;
+		node* n = reinterpret_cast<node*>(slab + pos);
+		n->h.owner = c;
+		n->h.size_class = size_class;
+		n->next = list;
+		list = n;
+	}
+	c->free_lists[size_class] = list;
+}
+
+inline void slab_recycler::increment(std::atomic<std::uint64_t>& counter) noexcept {
+	counter.store(counter.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+}
+
+/// Makes Derived in recycled memory
+template <class Derived, class... Args>
+inline Derived* recycling_create(Args&&... args) {
+	static_assert(alignof(Derived) <= slab_recycler::max_align,
+		"recycling_delete: objects can't be aligned stronger than max_align_t");
+
+	void* memory = slab_recycler::instance().allocate(sizeof(Derived));
+	try {
+		return new (memory) Derived(std::forward<Args>(args)...);
+	}
+	catch (...) {
+		slab_recycler::instance().deallocate(memory);
+		throw;
+	}
+}
+
+/// Copies Derived into recycled memory
+template<class Base, class Derived>
+inline typename std::enable_if<
+	std::is_copy_constructible<Derived>::value, Base*>::type
+	recycling_clone(const Base* other) {
+	const Derived* temp = inheritance_traits<Base, Derived>::downcast(other);
+	return recycling_create<Derived>(*temp);
+}
+
+/// Placeholder for when Derived is not CopyConstructible. Throws on call.
+template<class Base, class Derived>
+inline typename std::enable_if<
+	!std::is_copy_constructible<Derived>::value, Base*>::type
+	recycling_clone(const Base*) {
+	throw std::runtime_error(
+		std::string("poly: poly<") +
+		POLY_TYPE_NAME(Base) +
+		"> is attempting to copy '" +
+		POLY_TYPE_NAME(Derived) +
+		"', which is not copy-constructible");
+}
+
+} // namespace detail
+
+// class recycling_copy ========================================================
+
+template<class Base>
+constexpr recycling_copy<Base>::recycling_copy() noexcept :
+	clone_ptr(nullptr) {
+}
+
+template<class Base>
+template<class Base2>
+inline recycling_copy<Base>::recycling_copy(const recycling_copy<Base2>& other) noexcept :
+	clone_ptr(other.clone_ptr) {
+}
+
+template<class Base>
+template<class Derived>
+inline recycling_copy<Base>::recycling_copy(const Derived*) :
+	clone_ptr(&detail::recycling_clone<Base, Derived>) {
+	static_assert(std::is_base_of<Base, Derived>::value,
+		"recycling_copy: Base is not base of Derived");
+}
+
+template<class Base>
+inline Base* recycling_copy<Base>::operator()(const Base* other) {
+	return clone_ptr(other);
+}
+
+// class recycling_delete ======================================================
+
+template<class Base>
+template<class Base2>
+inline recycling_delete<Base>::recycling_delete(const recycling_delete<Base2>&) noexcept {
+}
+
+template<class Base>
+template<class Derived, class... Args>
+inline Derived* recycling_delete<Base>::create(Args&&... args) {
+	return detail::recycling_create<Derived>(std::forward<Args>(args)...);
+}
+
+template<class Base>
+inline void recycling_delete<Base>::operator()(const Base* ptr) const {
+	static_assert(std::has_virtual_destructor<Base>::value,
+		"recycling_delete: Base does not have a virtual destructor, a memory leak will occur.");
+	if (!ptr) return;
+
+	// The memory starts at the most derived object
+	void* memory = const_cast<void*>(dynamic_cast<const void*>(ptr));
+	ptr->~Base();
+	detail::slab_recycler::instance().deallocate(memory);
+}
+
+} // namespace pl
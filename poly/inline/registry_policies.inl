@@ -0,0 +1,51 @@
+#pragma once
+#include <stdexcept> // runtime_error
+#include <string>    // string
+#include "registry_policies.hpp"
+
+namespace pl {
+namespace detail {
+
+// Finds the registry entry for the dynamic type of ptr. Throws if the type
+// was never adopted by a registry policy, for any base (i.e. the pointer was
+// released from a poly with a different policy and adopted without a type).
+template <class Base>
+inline const type_entry<typename std::remove_cv<Base>::type>&
+registry_find(const Base* ptr) {
+	using registry = type_registry<typename std::remove_cv<Base>::type>;
+
+	auto rslt = registry::find(ptr);
+	if (rslt == nullptr)
+		throw std::runtime_error(
+			std::string("poly: type '") +
+			typeid(*ptr).name() +
+			"' is not registered for base '" +
+			POLY_TYPE_NAME(Base) + "'");
+	return *rslt;
+}
+
+} // namespace detail
+
+// class registry_copy =========================================================
+
+template<class Base>
+template<class Base2>
+inline registry_copy<Base>::registry_copy(const registry_copy<Base2>&) noexcept {
+}
+
+template<class Base>
+template<class Derived>
+inline registry_copy<Base>::registry_copy(const Derived*) {
+	static_assert(std::is_base_of<Base, Derived>::value,
+		"registry_copy: Base is not base of Derived");
+
+	detail::type_registry<typename std::remove_cv<Base>::type>::
+		template insert<typename std::remove_cv<Derived>::type>();
+}
+
+template<class Base>
+inline Base* registry_copy<Base>::operator()(const Base* other) const {
+	return detail::registry_find(other).clone(other);
+}
+
+} // namespace pl
@@ -0,0 +1,62 @@
+#pragma once
+#include <cstring> // memmove
+#include <new>     // placement new
+#include <utility> // move
+#include "relocate.hpp"
+
+namespace pl {
+namespace detail {
+
+template <class T>
+inline void relocate_bytes(T* first, T* last, T* dest) {
+	if (first == last) return;
+	std::memmove(static_cast<void*>(dest), static_cast<const void*>(first),
+		static_cast<std::size_t>(last - first) * sizeof(T));
+}
+
+template <class T>
+inline T* relocate(T* first, T* last, T* dest, std::true_type) {
+	relocate_bytes(first, last, dest);
+	return dest + (last - first);
+}
+
+template <class T>
+inline T* relocate(T* first, T* last, T* dest, std::false_type) {
+	for (; first != last; ++first, ++dest) {
+		new (dest) T(std::move(*first));
+		first->~T();
+	}
+	return dest;
+}
+
+template <class T>
+inline T* relocate_backward(T* first, T* last, T* dest, std::true_type) {
+	relocate_bytes(first, last, dest);
+	return dest + (last - first);
+}
+
+template <class T>
+inline T* relocate_backward(T* first, T* last, T* dest, std::false_type) {
+	T* rslt = dest + (last - first);
+	for (T* out = rslt; last != first; ) {
+		--last;
+		--out;
+		new (out) T(std::move(*last));
+		last->~T();
+	}
+	return rslt;
+}
+
+} // namespace detail
+
+template <class T>
+inline T* relocate(T* first, T* last, T* dest) {
+	return detail::relocate(first, last, dest, is_trivially_relocatable<T>());
+}
+
+template <class T>
+inline T* relocate_backward(T* first, T* last, T* dest) {
+	return detail::relocate_backward(first, last, dest, is_trivially_relocatable<T>());
+}
+
+} // namespace pl
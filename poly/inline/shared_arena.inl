@@ -0,0 +1,235 @@
+#pragma once
+#include <new>         // bad_alloc, placement new
+#include <stdexcept>   // runtime_error
+#include <string>      // string
+#include <type_traits> // is_base_of, is_copy_constructible
+#include <utility>     // forward
+#include "shared_arena.hpp"
+#include "inheritance_traits.hpp"
+
+#ifdef POLY_SHARED_MEMORY
+#include <sys/mman.h> // mmap, munmap
+#include <unistd.h>   // getpid
+#endif
+
+namespace pl {
+
+// class shared_arena ==========================================================
+
+inline shared_arena::shared_arena(std::size_t capacity) :
+	memory(nullptr) {
+#ifdef POLY_SHARED_MEMORY
+	std::size_t size = sizeof(control) + capacity;
+	void* rslt = mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_ANONYMOUS, -1, 0);
+	if (rslt == MAP_FAILED) throw std::runtime_error("shared_arena: can't map shared memory");
+
+	memory = new (rslt) control;
+	memory->top.store(sizeof(control), std::memory_order_relaxed);
+	memory->live.store(0, std::memory_order_relaxed);
+	memory->size = size;
+
+	// Processes don't share locks of std::atomic
+	if (!memory->top.is_lock_free()) {
+		munmap(rslt, size);
+		throw std::runtime_error("shared_arena: atomic counters are not lock-free");
+	}
+#else
+	(void)capacity;
+	throw std::runtime_error("shared_arena: shared memory is not supported on this platform");
+#endif
+}
+
+inline shared_arena::~shared_arena() {
+#ifdef POLY_SHARED_MEMORY
+	munmap(memory, memory->size);
+#endif
+}
+
+// Statistics ==================================================================
+
+inline std::size_t shared_arena::capacity() const noexcept {
+	return memory->size - sizeof(control);
+}
+
+inline std::size_t shared_arena::used() const noexcept {
+	return memory->top.load(std::memory_order_relaxed) - sizeof(control);
+}
+
+inline std::size_t shared_arena::live() const noexcept {
+	return memory->live.load(std::memory_order_relaxed);
+}
+
+// Memory ======================================================================
+
+inline void* shared_arena::allocate(std::size_t size) {
+	return take(memory, size);
+}
+
+inline bool shared_arena::contains(const void* ptr) const noexcept {
+	const unsigned char* start = reinterpret_cast<const unsigned char*>(memory);
+	const unsigned char* p = static_cast<const unsigned char*>(ptr);
+	return p >= start + sizeof(control) && p < start + memory->size;
+}
+
+inline std::size_t shared_arena::offset_of(const void* ptr) const noexcept {
+	return static_cast<const unsigned char*>(ptr) - reinterpret_cast<const unsigned char*>(memory);
+}
+
+template <class T>
+inline T* shared_arena::at(std::size_t offset) const noexcept {
+	return reinterpret_cast<T*>(reinterpret_cast<unsigned char*>(memory) + offset);
+}
+
+// Objects =====================================================================
+
+template <class T, class... Args>
+inline T* shared_arena::create(Args&&... args) {
+	return construct<T>(memory, std::forward<Args>(args)...);
+}
+
+template <class T>
+inline T* shared_arena::copy(const T& obj) {
+	return construct<T>(control_of(header_of(dynamic_cast<const void*>(&obj))), obj);
+}
+
+template <class Base>
+inline void shared_arena::destroy(const Base* obj) noexcept {
+	using type = typename std::remove_const<Base>::type;
+
+	header* h = header_of(dynamic_cast<const void*>(obj));
+	if (h->maker != current_process()) return;
+
+	obj->~type();
+	control_of(h)->live.fetch_sub(h->size, std::memory_order_relaxed);
+}
+
+// Private functions ===========================================================
+
+inline unsigned char* shared_arena::take(control* c, std::size_t size) {
+	size = (size + max_align - 1) / max_align * max_align;
+
+	std::size_t top = c->top.load(std::memory_order_relaxed);
+	do {
+		if (c->size - top < size) throw std::bad_alloc();
+	} while (!c->top.compare_exchange_weak(top, top + size, std::memory_order_relaxed));
+
+	return reinterpret_cast<unsigned char*>(c) + top;
+}
+
+template <class T, class... Args>
+inline T* shared_arena::construct(control* c, Args&&... args) {
+	static_assert(alignof(T) <= max_align,
+		"shared_arena: objects can't be aligned stronger than max_align");
+
+	std::size_t size = sizeof(header) + sizeof(T);
+	header* h = reinterpret_cast<header*>(take(c, size));
+	h->offset = reinterpret_cast<unsigned char*>(h) - reinterpret_cast<unsigned char*>(c);
+	h->size = size;
+	h->maker = current_process();
+
+	// The memory is lost if the constructor throws, as with destroyed objects
+	T* rslt = new (h + 1) T(std::forward<Args>(args)...);
+	c->live.fetch_add(size, std::memory_order_relaxed);
+	return rslt;
+}
+
+inline shared_arena::header* shared_arena::header_of(const void* most_derived) noexcept {
+	return static_cast<header*>(const_cast<void*>(most_derived)) - 1;
+}
+
+inline shared_arena::control* shared_arena::control_of(header* h) noexcept {
+	return reinterpret_cast<control*>(reinterpret_cast<unsigned char*>(h) - h->offset);
+}
+
+inline long shared_arena::current_process() noexcept {
+#ifdef POLY_SHARED_MEMORY
+	return static_cast<long>(getpid());
+#else
+	return 0;
+#endif
+}
+
+// make ========================================================================
+
+template <class PolyType, class Derived, class... Args>
+inline PolyType make(shared_arena& arena, Args&&... args) {
+	return detail::from_created<PolyType>(
+		arena.template create<Derived>(std::forward<Args>(args)...));
+}
+
+namespace detail {
+
+/// Copies Derived into the arena of other. Returns a non-const pointer, so
+/// that polys of const Base can be copied.
+template<class Base, class Derived>
+inline typename std::enable_if<std::is_copy_constructible<Derived>::value,
+	typename std::remove_const<Base>::type*>::type
+	shared_arena_clone(const Base* other) {
+	const Derived* temp = inheritance_traits<Base, Derived>::downcast(other);
+	return shared_arena::copy(*temp);
+}
+
+/// Placeholder for when Derived is not CopyConstructible. Throws on call.
+template<class Base, class Derived>
+inline typename std::enable_if<!std::is_copy_constructible<Derived>::value,
+	typename std::remove_const<Base>::type*>::type
+	shared_arena_clone(const Base*) {
+	throw std::runtime_error(
+		std::string("poly: poly<") +
+		POLY_TYPE_NAME(Base) +
+		"> is attempting to copy '" +
+		POLY_TYPE_NAME(Derived) +
+		"', which is not copy-constructible");
+}
+
+} // namespace detail
+
+// class shared_arena_copy =====================================================
+
+template<class Base>
+constexpr shared_arena_copy<Base>::shared_arena_copy() noexcept :
+	clone_ptr(nullptr) {
+}
+
+template<class Base>
+template<class Base2>
+inline shared_arena_copy<Base>::shared_arena_copy(const shared_arena_copy<Base2>& other) noexcept :
+	clone_ptr(other.clone_ptr) {
+}
+
+template<class Base>
+template<class Derived>
+inline shared_arena_copy<Base>::shared_arena_copy(const Derived*) :
+	clone_ptr(&detail::shared_arena_clone<Base, Derived>) {
+	static_assert(std::is_base_of<Base, Derived>::value,
+		"shared_arena_copy: Base is not base of Derived");
+}
+
+template<class Base>
+inline Base* shared_arena_copy<Base>::operator()(const Base* other) {
+	return clone_ptr(other);
+}
+
+// class shared_arena_delete ===================================================
+
+template<class Base>
+template<class Base2>
+inline shared_arena_delete<Base>::shared_arena_delete(const shared_arena_delete<Base2>&) noexcept {
+}
+
+template<class Base>
+template<class Derived, class... Args>
+inline Derived* shared_arena_delete<Base>::create(Args&&...) {
+	static_assert(sizeof(Derived) == 0,
+		"shared_arena_delete: objects must be made with pl::make(arena, args...)");
+	return nullptr;
+}
+
+template<class Base>
+inline void shared_arena_delete<Base>::operator()(const Base* ptr) const {
+	static_assert(std::has_virtual_destructor<Base>::value,
+		"shared_arena_delete: Base does not have a virtual destructor, a memory leak will occur.");
+	if (ptr) shared_arena::destroy(ptr);
+}
+
+} // namespace pl
@@ -0,0 +1,80 @@
+#pragma once
+#include "snapshot_map.hpp"
+
+namespace pl {
+namespace detail {
+
+template<class Key, class Value, class Hash>
+inline snapshot_map<Key, Value, Hash>::table::table(std::size_t bucket_count) :
+	mask(bucket_count - 1),
+	buckets(new std::atomic<const link*>[bucket_count]) {
+	for (std::size_t i = 0; i < bucket_count; ++i) {
+		buckets[i].store(nullptr, std::memory_order_relaxed);
+	}
+}
+
+template<class Key, class Value, class Hash>
+inline snapshot_map<Key, Value, Hash>::snapshot_map() noexcept :
+	current(nullptr) {
+}
+
+template<class Key, class Value, class Hash>
+inline const Value* snapshot_map<Key, Value, Hash>::find(const Key& key) const noexcept {
+	const table* t = current.load(std::memory_order_acquire);
+	if (t == nullptr) return nullptr;
+
+	const link* l = t->buckets[bucket_of(key, t->mask)].load(std::memory_order_acquire);
+	for (; l; l = l->next) {
+		if (l->item->key == key) return &l->item->value;
+	}
+	return nullptr;
+}
+
+template<class Key, class Value, class Hash>
+inline const Value& snapshot_map<Key, Value, Hash>::insert(const Key& key, const Value& value) {
+	std::lock_guard<std::mutex> lock(write_mutex);
+
+	const Value* found = find(key);
+	if (found) return *found;
+
+	entries.push_back(entry{key, value});
+	try {
+		if (tables.empty() || entries.size() > tables.back()->mask + 1) {
+			// Load factor 1. The old table stays valid for current readers.
+			std::size_t bucket_count = tables.empty() ? 16 : 2 * (tables.back()->mask + 1);
+			std::unique_ptr<table> next(new table(bucket_count));
+			for (const entry& e : entries) add(*next, &e);
+
+			tables.push_back(std::move(next));
+			current.store(tables.back().get(), std::memory_order_release);
+		}
+		else {
+			add(*tables.back(), &entries.back());
+		}
+	}
+	catch (...) {
+		entries.pop_back();
+		throw;
+	}
+
+	return entries.back().value;
+}
+
+template<class Key, class Value, class Hash>
+inline std::size_t snapshot_map<Key, Value, Hash>::bucket_of(const Key& key, std::size_t mask) noexcept {
+	// Pointers, hashed to themselves, have their low bits clear
+	std::size_t h = Hash()(key);
+	h ^= h >> 4;
+	h ^= h >> 16;
+	return h & mask;
+}
+
+template<class Key, class Value, class Hash>
+inline void snapshot_map<Key, Value, Hash>::add(table& t, const entry* item) {
+	std::atomic<const link*>& bucket = t.buckets[bucket_of(item->key, t.mask)];
+	t.links.push_back(link{item, bucket.load(std::memory_order_relaxed)});
+	bucket.store(&t.links.back(), std::memory_order_release);
+}
+
+} // namespace detail
+} // namespace pl
@@ -0,0 +1,312 @@
+#pragma once
+#include <algorithm> // copy_backward, fill, min, remove
+#include <stdexcept> // length_error
+#include <utility>   // forward, move
+#include "tagged_vector.hpp"
+
+#if defined(__AVX2__)
+#include <immintrin.h>
+#define POLY_TAG_SCAN_AVX2
+#elif defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define POLY_TAG_SCAN_SSE2
+#endif
+
+#if defined(_MSC_VER) && (defined(POLY_TAG_SCAN_AVX2) || defined(POLY_TAG_SCAN_SSE2))
+#include <intrin.h> // _BitScanForward
+#endif
+
+namespace pl {
+namespace detail {
+
+// Tag scans ===================================================================
+
+/// Returns the position of the lowest set bit. mask must not be 0.
+inline unsigned lowest_bit(unsigned mask) noexcept {
+#ifdef _MSC_VER
+	unsigned long rslt;
+	_BitScanForward(&rslt, mask);
+	return static_cast<unsigned>(rslt);
+#else
+	return static_cast<unsigned>(__builtin_ctz(mask));
+#endif
+}
+
+/// Calls f(first + i) for every set bit i of mask, lowest first
+template <class F>
+inline void for_each_bit(unsigned mask, std::size_t first, F& f) {
+	while (mask != 0) {
+		f(first + lowest_bit(mask));
+		mask &= mask - 1;
+	}
+}
+
+inline std::size_t tag_count(const std::uint8_t* tags, std::size_t n, std::uint8_t tag) noexcept {
+	std::size_t rslt = 0;
+	std::size_t i = 0;
+
+	// Every match subtracts -1 from an 8-bit counter, which is summed up
+	// and reset before it can overflow, every 255 steps.
+#if defined(POLY_TAG_SCAN_AVX2)
+	const __m256i needle = _mm256_set1_epi8(static_cast<char>(tag));
+	while (n - i >= 32) {
+		std::size_t steps = std::min<std::size_t>((n - i) / 32, 255);
+		__m256i counters = _mm256_setzero_si256();
+		for (std::size_t s = 0; s < steps; ++s, i += 32) {
+			__m256i block = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(tags + i));
+			counters = _mm256_sub_epi8(counters, _mm256_cmpeq_epi8(block, needle));
+		}
+
+		alignas(32) std::uint64_t sums[4];
+		_mm256_store_si256(reinterpret_cast<__m256i*>(sums),
+			_mm256_sad_epu8(counters, _mm256_setzero_si256()));
+		rslt += static_cast<std::size_t>(sums[0] + sums[1] + sums[2] + sums[3]);
+	}
+#elif defined(POLY_TAG_SCAN_SSE2)
+	const __m128i needle = _mm_set1_epi8(static_cast<char>(tag));
+	while (n - i >= 16) {
+		std::size_t steps = std::min<std::size_t>((n - i) / 16, 255);
+		__m128i counters = _mm_setzero_si128();
+		for (std::size_t s = 0; s < steps; ++s, i += 16) {
+			__m128i block = _mm_loadu_si128(reinterpret_cast<const __m128i*>(tags + i));
+			counters = _mm_sub_epi8(counters, _mm_cmpeq_epi8(block, needle));
+		}
+
+		alignas(16) std::uint64_t sums[2];
+		_mm_store_si128(reinterpret_cast<__m128i*>(sums),
+			_mm_sad_epu8(counters, _mm_setzero_si128()));
+		rslt += static_cast<std::size_t>(sums[0] + sums[1]);
+	}
+#endif
+
+	for (; i < n; ++i) {
+		if (tags[i] == tag) ++rslt;
+	}
+	return rslt;
+}
+
+template <class F>
+inline void tag_scan(const std::uint8_t* tags, std::size_t n, std::uint8_t tag, F&& f) {
+	std::size_t i = 0;
+
+#if defined(POLY_TAG_SCAN_AVX2)
+	const __m256i needle = _mm256_set1_epi8(static_cast<char>(tag));
+	for (; n - i >= 32; i += 32) {
+		__m256i block = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(tags + i));
+		for_each_bit(static_cast<unsigned>(
+			_mm256_movemask_epi8(_mm256_cmpeq_epi8(block, needle))), i, f);
+	}
+#elif defined(POLY_TAG_SCAN_SSE2)
+	const __m128i needle = _mm_set1_epi8(static_cast<char>(tag));
+	for (; n - i >= 16; i += 16) {
+		__m128i block = _mm_loadu_si128(reinterpret_cast<const __m128i*>(tags + i));
+		for_each_bit(static_cast<unsigned>(
+			_mm_movemask_epi8(_mm_cmpeq_epi8(block, needle))), i, f);
+	}
+#endif
+
+	for (; i < n; ++i) {
+		if (tags[i] == tag) f(i);
+	}
+}
+
+} // namespace detail
+
+// class tagged_vector =========================================================
+
+template <class Base, class CopyDeletePolicy>
+constexpr typename tagged_vector<Base, CopyDeletePolicy>::tag_type
+tagged_vector<Base, CopyDeletePolicy>::empty_tag;
+
+template <class Base, class CopyDeletePolicy>
+constexpr typename tagged_vector<Base, CopyDeletePolicy>::tag_type
+tagged_vector<Base, CopyDeletePolicy>::no_tag;
+
+template <class Base, class CopyDeletePolicy>
+constexpr std::size_t tagged_vector<Base, CopyDeletePolicy>::max_types;
+
+// Iterators ===================================================================
+
+template <class Base, class CopyDeletePolicy>
+inline typename tagged_vector<Base, CopyDeletePolicy>::const_iterator
+tagged_vector<Base, CopyDeletePolicy>::begin() const noexcept {
+	return values.begin();
+}
+
+template <class Base, class CopyDeletePolicy>
+inline typename tagged_vector<Base, CopyDeletePolicy>::const_iterator
+tagged_vector<Base, CopyDeletePolicy>::end() const noexcept {
+	return values.end();
+}
+
+// Capacity ====================================================================
+
+template <class Base, class CopyDeletePolicy>
+inline bool tagged_vector<Base, CopyDeletePolicy>::empty() const noexcept {
+	return values.empty();
+}
+
+template <class Base, class CopyDeletePolicy>
+inline typename tagged_vector<Base, CopyDeletePolicy>::size_type
+tagged_vector<Base, CopyDeletePolicy>::size() const noexcept {
+	return values.size();
+}
+
+template <class Base, class CopyDeletePolicy>
+inline void tagged_vector<Base, CopyDeletePolicy>::reserve(size_type new_capacity) {
+	values.reserve(new_capacity);
+	tag_array.reserve(new_capacity);
+}
+
+// Element access ==============================================================
+
+template <class Base, class CopyDeletePolicy>
+inline const typename tagged_vector<Base, CopyDeletePolicy>::value_type&
+tagged_vector<Base, CopyDeletePolicy>::operator[](size_type i) const {
+	return values[i];
+}
+
+// Tags ========================================================================
+
+template <class Base, class CopyDeletePolicy>
+inline typename tagged_vector<Base, CopyDeletePolicy>::tag_type
+tagged_vector<Base, CopyDeletePolicy>::tag(size_type i) const {
+	return tag_array[i];
+}
+
+template <class Base, class CopyDeletePolicy>
+inline const typename tagged_vector<Base, CopyDeletePolicy>::tag_type*
+tagged_vector<Base, CopyDeletePolicy>::tags() const noexcept {
+	return tag_array.data();
+}
+
+template <class Base, class CopyDeletePolicy>
+template <class T>
+inline typename tagged_vector<Base, CopyDeletePolicy>::tag_type
+tagged_vector<Base, CopyDeletePolicy>::tag_of() const noexcept {
+	const std::type_info& type = typeid(T);
+	for (std::size_t i = 0; i < types.size(); ++i) {
+		if (types[i] == &type || *types[i] == type) return static_cast<tag_type>(i + 1);
+	}
+	return no_tag;
+}
+
+template <class Base, class CopyDeletePolicy>
+inline const std::type_info*
+tagged_vector<Base, CopyDeletePolicy>::type_of(tag_type tag) const noexcept {
+	return tag != empty_tag && tag <= types.size() ? types[tag - 1] : nullptr;
+}
+
+// Queries =====================================================================
+
+template <class Base, class CopyDeletePolicy>
+template <class T>
+inline typename tagged_vector<Base, CopyDeletePolicy>::size_type
+tagged_vector<Base, CopyDeletePolicy>::count() const noexcept {
+	tag_type tag = tag_of<T>();
+	if (tag == no_tag) return 0;
+
+	return detail::tag_count(tag_array.data(), tag_array.size(), tag);
+}
+
+template <class Base, class CopyDeletePolicy>
+template <class T, class OutputIt>
+inline OutputIt tagged_vector<Base, CopyDeletePolicy>::find_all(OutputIt out) const {
+	tag_type tag = tag_of<T>();
+	if (tag == no_tag) return out;
+
+	detail::tag_scan(tag_array.data(), tag_array.size(), tag,
+		[&out](std::size_t i) { *out++ = i; });
+	return out;
+}
+
+// Modifiers ===================================================================
+
+template <class Base, class CopyDeletePolicy>
+inline void tagged_vector<Base, CopyDeletePolicy>::push_back(value_type value) {
+	tag_array.push_back(tag_for(value));
+	try {
+		values.push_back(std::move(value));
+	}
+	catch (...) {
+		tag_array.pop_back();
+		throw;
+	}
+}
+
+template <class Base, class CopyDeletePolicy>
+template <class Derived, class... Args>
+inline void tagged_vector<Base, CopyDeletePolicy>::emplace_back(Args&&... args) {
+	push_back(make<value_type, Derived>(std::forward<Args>(args)...));
+}
+
+template <class Base, class CopyDeletePolicy>
+inline void tagged_vector<Base, CopyDeletePolicy>::pop_back() {
+	values.pop_back();
+	tag_array.pop_back();
+}
+
+template <class Base, class CopyDeletePolicy>
+inline void tagged_vector<Base, CopyDeletePolicy>::set(size_type i, value_type value) {
+	tag_type tag = tag_for(value);
+	values[i] = std::move(value);
+	tag_array[i] = tag;
+}
+
+template <class Base, class CopyDeletePolicy>
+inline void tagged_vector<Base, CopyDeletePolicy>::erase(size_type i) {
+	values.erase(values.begin() + i);
+	tag_array.erase(tag_array.begin() + i);
+}
+
+template <class Base, class CopyDeletePolicy>
+inline void tagged_vector<Base, CopyDeletePolicy>::clear() noexcept {
+	values.clear();
+	tag_array.clear();
+	types.clear();
+}
+
+template <class Base, class CopyDeletePolicy>
+template <class T>
+inline typename tagged_vector<Base, CopyDeletePolicy>::size_type
+tagged_vector<Base, CopyDeletePolicy>::partition() {
+	tag_type tag = tag_of<T>();
+	if (tag == no_tag) return 0;
+
+	pl::vector<value_type> rslt;
+	rslt.reserve(values.size());
+	detail::tag_scan(tag_array.data(), tag_array.size(), tag,
+		[&](std::size_t i) { rslt.push_back(std::move(values[i])); });
+
+	size_type n = rslt.size();
+	for (size_type i = 0; i < values.size(); ++i) {
+		if (tag_array[i] != tag) rslt.push_back(std::move(values[i]));
+	}
+	values = std::move(rslt);
+
+	// Other tags keep their order, and are moved to the back
+	auto rest = std::remove(tag_array.begin(), tag_array.end(), tag);
+	std::copy_backward(tag_array.begin(), rest, tag_array.end());
+	std::fill(tag_array.begin(), tag_array.begin() + n, tag);
+
+	return n;
+}
+
+template <class Base, class CopyDeletePolicy>
+inline typename tagged_vector<Base, CopyDeletePolicy>::tag_type
+tagged_vector<Base, CopyDeletePolicy>::tag_for(const value_type& value) {
+	if (!value) return empty_tag;
+
+	const std::type_info& type = typeid(*value);
+	for (std::size_t i = 0; i < types.size(); ++i) {
+		if (types[i] == &type || *types[i] == type) return static_cast<tag_type>(i + 1);
+	}
+
+	if (types.size() == max_types) {
+		throw std::length_error("tagged_vector: too many types");
+	}
+	types.push_back(&type);
+	return static_cast<tag_type>(types.size());
+}
+
+} // namespace pl
@@ -0,0 +1,61 @@
+#pragma once
+#include <new>         // placement new
+#include <type_traits> // integral_constant, is_*_constructible
+#include <utility>     // move
+#include "type_layout.hpp"
+#include "inheritance_traits.hpp"
+
+namespace pl {
+namespace detail {
+
+/// Lifetime functions of Derived. Each of construct, copy and move returns
+/// nullptr (the false_type overload) if Derived doesn't support it.
+template <class Base, class Derived>
+struct layout_functions {
+	using poly_type = typename type_layout<Base>::poly_type;
+
+	static poly_type construct_impl(void* memory) {
+		return poly_type(new (memory) Derived());
+	}
+
+	static poly_type copy_impl(void* memory, const Base& other) {
+		return poly_type(new (memory) Derived(
+			*inheritance_traits<Base, Derived>::downcast(&other)));
+	}
+
+	static poly_type move_impl(void* memory, Base& other) {
+		return poly_type(new (memory) Derived(
+			std::move(*inheritance_traits<Base, Derived>::downcast(&other))));
+	}
+
+	static void destroy(Base* obj) {
+		inheritance_traits<Base, Derived>::downcast(obj)->~Derived();
+	}
+
+	static poly_type (*construct(std::true_type))(void*) { return &construct_impl; }
+	static poly_type (*construct(std::false_type))(void*) { return nullptr; }
+
+	static poly_type (*copy(std::true_type))(void*, const Base&) { return &copy_impl; }
+	static poly_type (*copy(std::false_type))(void*, const Base&) { return nullptr; }
+
+	static poly_type (*move(std::true_type))(void*, Base&) { return &move_impl; }
+	static poly_type (*move(std::false_type))(void*, Base&) { return nullptr; }
+};
+
+template <class Base, class Derived>
+inline const type_layout<Base>* layout_of() {
+	using functions = layout_functions<Base, Derived>;
+
+	static const type_layout<Base> rslt = {
+		sizeof(Derived),
+		alignof(Derived),
+		functions::construct(std::is_default_constructible<Derived>()),
+		functions::copy(std::is_copy_constructible<Derived>()),
+		functions::move(std::is_move_constructible<Derived>()),
+		&functions::destroy
+	};
+	return &rslt;
+}
+
+} // namespace detail
+} // namespace pl
@@ -0,0 +1,102 @@
+#pragma once
+#include <stdexcept>   // runtime_error
+#include <string>      // string
+#include <type_traits> // enable_if, is_copy_constructible
+#include "type_registry.hpp"
+#include "inheritance_traits.hpp"
+
+namespace pl {
+namespace detail {
+
+// erased_type =================================================================
+
+template <class T>
+inline typename std::enable_if<std::is_copy_constructible<T>::value, void*>::type
+erased_clone(const void* obj) {
+	return new T(*static_cast<const T*>(obj));
+}
+
+/// Placeholder for when T is not CopyConstructible. Throws on call.
+template <class T>
+inline typename std::enable_if<!std::is_copy_constructible<T>::value, void*>::type
+erased_clone(const void*) {
+	throw std::runtime_error(
+		std::string("poly: attempting to copy '") +
+		POLY_TYPE_NAME(T) +
+		"', which is not copy-constructible");
+}
+
+template <class T>
+const erased_type erased_model<T>::value = {
+	&erased_clone<T>
+};
+
+inline snapshot_map<const std::type_info*, const erased_type*>& erased_types() {
+	static snapshot_map<const std::type_info*, const erased_type*> rslt;
+	return rslt;
+}
+
+inline snapshot_map<std::type_index, const erased_type*>& erased_names() {
+	static snapshot_map<std::type_index, const erased_type*> rslt;
+	return rslt;
+}
+
+inline const erased_type* find_erased(const std::type_info& type) {
+	const erased_type* const* rslt = erased_types().find(&type);
+	if (rslt) return *rslt;
+
+	// Hashing the name is only needed for another copy of the type_info
+	rslt = erased_names().find(std::type_index(type));
+	if (rslt == nullptr) return nullptr;
+	return erased_types().insert(&type, *rslt);
+}
+
+template <class T>
+inline void register_type() {
+	static const bool registered =
+		(erased_names().insert(typeid(T), &erased_model<T>::value),
+		erased_types().insert(&typeid(T), &erased_model<T>::value), true);
+	(void)registered;
+}
+
+// type_entry ==================================================================
+
+template<class Base>
+inline Base* type_entry<Base>::clone(const Base* obj) const {
+	const unsigned char* most_derived = reinterpret_cast<const unsigned char*>(obj) - offset;
+	return reinterpret_cast<Base*>(static_cast<unsigned char*>(type->clone(most_derived)) + offset);
+}
+
+// type_registry ===============================================================
+
+template<class Base>
+inline snapshot_map<const std::type_info*, type_entry<Base>>& type_registry<Base>::entries() {
+	static snapshot_map<const std::type_info*, entry> rslt;
+	return rslt;
+}
+
+template<class Base>
+template<class Derived>
+inline void type_registry<Base>::insert() {
+	register_type<Derived>();
+}
+
+template<class Base>
+inline const typename type_registry<Base>::entry*
+type_registry<Base>::find(const Base* obj) {
+	const std::type_info& type = typeid(*obj);
+	const entry* rslt = entries().find(&type);
+	if (rslt) return rslt;
+
+	const erased_type* erased = find_erased(type);
+	if (erased == nullptr) return nullptr;
+
+	// The offset is the same for every object of the dynamic type, even with
+	// virtual bases
+	std::ptrdiff_t offset = reinterpret_cast<const unsigned char*>(obj) -
+		static_cast<const unsigned char*>(dynamic_cast<const void*>(obj));
+	return &entries().insert(&type, entry{erased, offset});
+}
+
+} // namespace detail
+} // namespace pl
@@ -0,0 +1,280 @@
+#pragma once
+#include <new>     // operator new, placement new
+#include <utility> // forward, move, swap
+#include "vector.hpp"
+
+namespace pl {
+
+// Construction ================================================================
+
+template<class T>
+inline vector<T>::vector() noexcept :
+	first(nullptr),
+	last(nullptr),
+	storage_end(nullptr) {
+}
+
+template<class T>
+inline vector<T>::vector(std::initializer_list<T> values) :
+	vector() {
+	reserve(values.size());
+	for (const T& value : values) push_back(value);
+}
+
+template<class T>
+inline vector<T>::vector(const vector& other) :
+	vector() {
+	reserve(other.size());
+	for (const T& value : other) push_back(value);
+}
+
+template<class T>
+inline vector<T>::vector(vector&& other) noexcept :
+	first(other.first),
+	last(other.last),
+	storage_end(other.storage_end) {
+	other.first = other.last = other.storage_end = nullptr;
+}
+
+template<class T>
+inline vector<T>& vector<T>::operator=(const vector& other) {
+	vector temp(other);
+	swap(temp);
+
+	return *this;
+}
+
+template<class T>
+inline vector<T>& vector<T>::operator=(vector&& other) noexcept {
+	vector temp(std::move(other));
+	swap(temp);
+
+	return *this;
+}
+
+template<class T>
+inline vector<T>::~vector() {
+	clear();
+	deallocate(first);
+}
+
+// Iterators ===================================================================
+
+template<class T>
+inline typename vector<T>::iterator vector<T>::begin() noexcept {
+	return first;
+}
+
+template<class T>
+inline typename vector<T>::const_iterator vector<T>::begin() const noexcept {
+	return first;
+}
+
+template<class T>
+inline typename vector<T>::iterator vector<T>::end() noexcept {
+	return last;
+}
+
+template<class T>
+inline typename vector<T>::const_iterator vector<T>::end() const noexcept {
+	return last;
+}
+
+// Capacity ====================================================================
+
+template<class T>
+inline bool vector<T>::empty() const noexcept {
+	return first == last;
+}
+
+template<class T>
+inline typename vector<T>::size_type vector<T>::size() const noexcept {
+	return static_cast<size_type>(last - first);
+}
+
+template<class T>
+inline typename vector<T>::size_type vector<T>::capacity() const noexcept {
+	return static_cast<size_type>(storage_end - first);
+}
+
+template<class T>
+inline void vector<T>::reserve(size_type new_capacity) {
+	if (new_capacity <= capacity()) return;
+
+	T* new_first = allocate(new_capacity);
+	T* new_last = relocate(first, last, new_first);
+	deallocate(first);
+
+	first = new_first;
+	last = new_last;
+	storage_end = new_first + new_capacity;
+}
+
+// Element access ==============================================================
+
+template<class T>
+inline T& vector<T>::operator[](size_type i) {
+	return first[i];
+}
+
+template<class T>
+inline const T& vector<T>::operator[](size_type i) const {
+	return first[i];
+}
+
+template<class T>
+inline T& vector<T>::front() {
+	return *first;
+}
+
+template<class T>
+inline const T& vector<T>::front() const {
+	return *first;
+}
+
+template<class T>
+inline T& vector<T>::back() {
+	return *(last - 1);
+}
+
+template<class T>
+inline const T& vector<T>::back() const {
+	return *(last - 1);
+}
+
+template<class T>
+inline T* vector<T>::data() noexcept {
+	return first;
+}
+
+template<class T>
+inline const T* vector<T>::data() const noexcept {
+	return first;
+}
+
+// Modifiers ===================================================================
+
+template<class T>
+inline void vector<T>::push_back(const T& value) {
+	emplace_back(value);
+}
+
+template<class T>
+inline void vector<T>::push_back(T&& value) {
+	emplace_back(std::move(value));
+}
+
+template<class T>
+template<class... Args>
+inline T& vector<T>::emplace_back(Args&&... args) {
+	return *emplace(last, std::forward<Args>(args)...);
+}
+
+template<class T>
+inline void vector<T>::pop_back() {
+	--last;
+	last->~T();
+}
+
+template<class T>
+inline typename vector<T>::iterator
+vector<T>::insert(const_iterator pos, const T& value) {
+	return emplace(pos, value);
+}
+
+template<class T>
+inline typename vector<T>::iterator
+vector<T>::insert(const_iterator pos, T&& value) {
+	return emplace(pos, std::move(value));
+}
+
+template<class T>
+template<class... Args>
+inline typename vector<T>::iterator
+vector<T>::emplace(const_iterator pos, Args&&... args) {
+	T* hole = first + (pos - first);
+
+	if (last == storage_end) {
+		// Construct the new element first: args may refer to an element
+		size_type new_capacity = next_capacity();
+		T* new_first = allocate(new_capacity);
+		T* new_hole = new_first + (hole - first);
+		try {
+			new (new_hole) T(std::forward<Args>(args)...);
+		}
+		catch (...) {
+			deallocate(new_first);
+			throw;
+		}
+
+		relocate(first, hole, new_first);
+		T* new_last = relocate(hole, last, new_hole + 1);
+		deallocate(first);
+
+		first = new_first;
+		last = new_last;
+		storage_end = new_first + new_capacity;
+		return new_hole;
+	}
+
+	if (hole == last) {
+		new (last) T(std::forward<Args>(args)...);
+		++last;
+		return hole;
+	}
+
+	T temp(std::forward<Args>(args)...);
+	relocate_backward(hole, last, hole + 1);
+	++last;
+	new (hole) T(std::move(temp));
+	return hole;
+}
+
+template<class T>
+inline typename vector<T>::iterator vector<T>::erase(const_iterator pos) {
+	return erase(pos, pos + 1);
+}
+
+template<class T>
+inline typename vector<T>::iterator
+vector<T>::erase(const_iterator first_erased, const_iterator last_erased) {
+	T* from = first + (first_erased - first);
+	T* to = first + (last_erased - first);
+	if (from == to) return from;
+
+	for (T* i = from; i != to; ++i) i->~T();
+	last = relocate(to, last, from);
+	return from;
+}
+
+template<class T>
+inline void vector<T>::clear() noexcept {
+	for (T* i = first; i != last; ++i) i->~T();
+	last = first;
+}
+
+template<class T>
+inline void vector<T>::swap(vector& other) noexcept {
+	std::swap(first, other.first);
+	std::swap(last, other.last);
+	std::swap(storage_end, other.storage_end);
+}
+
+// Private =====================================================================
+
+template<class T>
+inline typename vector<T>::size_type vector<T>::next_capacity() const noexcept {
+	return capacity() == 0 ? 4 : 2 * capacity();
+}
+
+template<class T>
+inline T* vector<T>::allocate(size_type n) {
+	return static_cast<T*>(::operator new(n * sizeof(T)));
+}
+
+template<class T>
+inline void vector<T>::deallocate(T* ptr) noexcept {
+	::operator delete(ptr);
+}
+
+} // namespace pl
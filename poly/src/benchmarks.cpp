@@ -0,0 +1,1253 @@
+#include <atomic>
+#include <chrono>
+#include <iostream>
+#include <iomanip>
+#include <cmath>
+#include <cstdint>
+#include <deque>
+#include <fstream>
+#include <memory>
+#include <mutex>
+#include <algorithm>
+#include <random>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+#include "benchmarks.hpp"
+#include "tests.hpp"
+#include "poly.hpp"
+#include "dispatch.hpp"
+#include "factory.hpp"
+#include "parallel.hpp"
+#include "parallel_algorithm.hpp"
+#include "deferred_delete.hpp"
+#include "atomic_poly.hpp"
+#include "lazy_poly.hpp"
+#include "any_of.hpp"
+#include "bound_method.hpp"
+#include "vector.hpp"
+#include "intern_pool.hpp"
+#include "inline_cache.hpp"
+#include "tagged_vector.hpp"
+#include "poly_slot_map.hpp"
+#include "poly_queue.hpp"
+#include "compacting_arena.hpp"
+#include "recycling_policies.hpp"
+#include "shared_arena.hpp"
+
+#ifdef POLY_SHARED_MEMORY
+#include <sys/wait.h> // waitpid
+#include <unistd.h>   // fork, _exit
+#endif
+
+using pl::poly;
+using namespace std;
+
+namespace {
+
+// Runs f once and returns the elapsed time in milliseconds
+template <class F>
+double time_ms(F&& f) {
+	auto start = chrono::steady_clock::now();
+	f();
+	auto end = chrono::steady_clock::now();
+	return chrono::duration<double, milli>(end - start).count();
+}
+
+// Fills a vector with n polys, cycling through the test hierarchy
+template <class PolyType>
+vector<PolyType> make_population(size_t n) {
+	vector<PolyType> rslt;
+	rslt.reserve(n);
+	for (size_t i = 0; i < n; ++i) {
+		switch (i % 3) {
+		case 0: rslt.push_back(pl::make<PolyType, Der>()); break;
+		case 1: rslt.push_back(pl::make<PolyType, Mid1>()); break;
+		case 2: rslt.push_back(pl::make<PolyType, Mid2>()); break;
+		}
+	}
+	return rslt;
+}
+
+// Handler for every pair of the test hierarchy, used for dispatch
+struct Pair_Score {
+	using result_type = int;
+
+	template <class T1, class T2>
+	int operator()(T1& x, T2& y) { return static_cast<int>(sizeof(x) + 2 * sizeof(y)); }
+};
+
+// Same as Pair_Score over dispatch, written as nested is<T>() checks
+template <class T1>
+int nested_score_2(T1& x, const poly<Base>& y) {
+	Pair_Score score;
+	if (y.is<Der>()) return score(x, *y.as<Der>());
+	if (y.is<Mid1>()) return score(x, *y.as<Mid1>());
+	if (y.is<Mid2>()) return score(x, *y.as<Mid2>());
+	if (y.is<Mid3>()) return score(x, *y.as<Mid3>());
+	return 0;
+}
+
+int nested_score(const poly<Base>& x, const poly<Base>& y) {
+	if (x.is<Der>()) return nested_score_2(*x.as<Der>(), y);
+	if (x.is<Mid1>()) return nested_score_2(*x.as<Mid1>(), y);
+	if (x.is<Mid2>()) return nested_score_2(*x.as<Mid2>(), y);
+	if (x.is<Mid3>()) return nested_score_2(*x.as<Mid3>(), y);
+	return 0;
+}
+
+// Sums name lengths, statically for listed types
+struct Name_Length {
+	size_t operator()(Der& x) const { return x.Der::name().size(); }
+	size_t operator()(Mid1& x) const { return x.Mid1::name().size(); }
+	size_t operator()(Mid2& x) const { return x.Mid2::name().size(); }
+	size_t operator()(Base& x) const { return x.name().size(); }
+};
+
+// An object with a large graph of owned allocations
+struct Heavy : Base {
+	vector<string> nodes;
+
+	Heavy() : nodes(1000, string(64, 'x')) {}
+};
+
+// An object with an expensive default constructor, that is then configured
+struct Table : Base {
+	vector<double> values;
+	double scale;
+
+	Table() : values(4096), scale(1) {
+		for (size_t i = 0; i < values.size(); ++i) {
+			values[i] = std::sin(0.001 * i) * std::exp(-0.0001 * i);
+		}
+	}
+};
+
+// Resets every poly and returns reset latencies in microseconds, sorted
+template <class PolyType>
+vector<double> reset_latencies(vector<PolyType>& objects) {
+	vector<double> rslt;
+	rslt.reserve(objects.size());
+
+	for (auto& p : objects) {
+		rslt.push_back(1000 * time_ms([&] { p.reset(); }));
+	}
+	sort(rslt.begin(), rslt.end());
+	return rslt;
+}
+
+double percentile(const vector<double>& sorted, double p) {
+	return sorted[static_cast<size_t>(p * (sorted.size() - 1))];
+}
+
+// Runs f(i) on the given number of threads and returns the total time in ms
+template <class F>
+double time_threads(size_t threads, F f) {
+	return time_ms([&] {
+		vector<thread> pool;
+		for (size_t i = 0; i < threads; ++i) pool.emplace_back(f, i);
+		for (auto& t : pool) t.join();
+	});
+}
+
+// Shapes with a virtual base, and the same shapes for any_of
+struct Shape_Base {
+	virtual double area() const = 0;
+	virtual ~Shape_Base() = default;
+};
+
+struct Virtual_Square : Shape_Base {
+	double side;
+
+	explicit Virtual_Square(double side) : side(side) {}
+	double area() const override { return side * side; }
+};
+
+struct Virtual_Circle : Shape_Base {
+	double radius;
+
+	explicit Virtual_Circle(double radius) : radius(radius) {}
+	double area() const override { return 3.14159 * radius * radius; }
+};
+
+struct Virtual_Triangle : Shape_Base {
+	double side;
+
+	explicit Virtual_Triangle(double side) : side(side) {}
+	double area() const override { return 0.433 * side * side; }
+};
+
+struct Virtual_Hexagon : Shape_Base {
+	double side;
+
+	explicit Virtual_Hexagon(double side) : side(side) {}
+	double area() const override { return 2.598 * side * side; }
+};
+
+struct Square {
+	double side;
+
+	double area() const { return side * side; }
+};
+
+struct Circle {
+	double radius;
+
+	double area() const { return 3.14159 * radius * radius; }
+};
+
+struct Area : pl::method<double() const> {
+	template <class T>
+	static double call(const T& shape) { return shape.area(); }
+};
+
+// Calls area() on the exact type, for bound
+struct Exact_Area : pl::method<double() const> {
+	template <class T>
+	static double call(const T& shape) { return shape.T::area(); }
+};
+
+// An immutable record, of which many copies are equal, for intern_pool
+struct Record : Base {
+	vector<int> values;
+
+	explicit Record(int key) : values(32, key) {}
+};
+
+struct Record_Hash {
+	size_t operator()(const Base& x) const {
+		return std::hash<int>()(static_cast<const Record&>(x).values[0]);
+	}
+};
+
+struct Record_Equal {
+	bool operator()(const Base& x, const Base& y) const {
+		return static_cast<const Record&>(x).values == static_cast<const Record&>(y).values;
+	}
+};
+
+// Calls area() on the exact type, or virtually for other types
+struct Area_Handler {
+	using result_type = double;
+
+	template <class T>
+	double operator()(const T& shape) const { return shape.T::area(); }
+	double operator()(const Shape_Base& shape) const { return shape.area(); }
+};
+
+// Fills a vector with shapes: the first type makes up share of all shapes,
+// the rest are split evenly between the other three types
+vector<poly<Shape_Base>> make_shapes(size_t n, double share) {
+	mt19937 gen(42);
+	uniform_real_distribution<double> dist(0, 1);
+
+	vector<poly<Shape_Base>> rslt;
+	rslt.reserve(n);
+	for (size_t i = 0; i < n; ++i) {
+		double x = dist(gen);
+		double rest = (1 - share) / 3;
+		if (x < share) rslt.push_back(pl::make<poly<Shape_Base>, Virtual_Square>(1.0));
+		else if (x < share + rest) rslt.push_back(pl::make<poly<Shape_Base>, Virtual_Circle>(1.0));
+		else if (x < share + 2 * rest) rslt.push_back(pl::make<poly<Shape_Base>, Virtual_Triangle>(1.0));
+		else rslt.push_back(pl::make<poly<Shape_Base>, Virtual_Hexagon>(1.0));
+	}
+	return rslt;
+}
+
+// A small per-thread object, written to in a loop
+struct Worker : Base {
+	std::atomic<long> counter;
+
+	Worker() : counter(0) {}
+	Worker(const Worker& other) : Base(other), counter(other.counter.load()) {}
+};
+
+// Counts on threads, each with its own worker, returns the time in ms
+template <class PolyType>
+double time_workers(size_t threads, size_t iterations) {
+	vector<PolyType> workers;
+	for (size_t i = 0; i < threads; ++i) workers.push_back(pl::make<PolyType, Worker>());
+
+	return time_threads(threads, [&](size_t t) {
+		Worker& w = *workers[t].template as<Worker>();
+		for (size_t i = 0; i < iterations; ++i) {
+			w.counter.fetch_add(1, memory_order_relaxed);
+		}
+	});
+}
+
+// A message, that remembers when it was sent
+struct Timed_Message {
+	chrono::steady_clock::time_point sent;
+
+	Timed_Message() : sent(chrono::steady_clock::now()) {}
+	virtual ~Timed_Message() = default;
+};
+
+using Timed_Poly = poly<Timed_Message, pl::unique<Timed_Message>>;
+
+// An unbounded queue, protected by a mutex
+struct Locked_Queue {
+	mutex m;
+	deque<Timed_Poly> messages;
+
+	void push(Timed_Poly msg) {
+		lock_guard<mutex> lock(m);
+		messages.push_back(std::move(msg));
+	}
+
+	bool try_pop(Timed_Poly& msg) {
+		lock_guard<mutex> lock(m);
+		if (messages.empty()) return false;
+		msg = std::move(messages.front());
+		messages.pop_front();
+		return true;
+	}
+};
+
+// Sends n messages in total from producers to consumers through a queue.
+// Returns the time in ms, and sets latency to the mean latency in us.
+template <class Queue>
+double time_pipeline(Queue& queue, size_t producers, size_t consumers, size_t n,
+	double& latency) {
+	atomic<size_t> received(0);
+	atomic<long long> total_latency(0);
+
+	double rslt = time_threads(producers + consumers, [&](size_t t) {
+		if (t < producers) {
+			size_t count = n / producers + (t < n % producers);
+			for (size_t i = 0; i < count; ++i) {
+				queue.push(pl::make<Timed_Poly, Timed_Message>());
+			}
+			return;
+		}
+
+		long long local_latency = 0;
+		Timed_Poly msg;
+		while (received.load(memory_order_relaxed) < n) {
+			if (!queue.try_pop(msg)) {
+				this_thread::yield();
+				continue;
+			}
+			local_latency += chrono::duration_cast<chrono::nanoseconds>(
+				chrono::steady_clock::now() - msg->sent).count();
+			msg.reset();
+			received.fetch_add(1, memory_order_relaxed);
+		}
+		total_latency += local_latency;
+	});
+
+	latency = total_latency / 1000.0 / n;
+	return rslt;
+}
+
+// A square with a payload, so that churned shapes have different sizes
+template <size_t Size>
+struct Padded_Square : Virtual_Square {
+	char payload[Size];
+
+	explicit Padded_Square(double side) : Virtual_Square(side) {}
+};
+
+// Resident set size in MB, or 0 where /proc/self/statm is not available.
+// Assumes 4K pages.
+double rss_mb() {
+	ifstream statm("/proc/self/statm");
+	size_t pages = 0;
+	size_t resident = 0;
+	if (!(statm >> pages >> resident)) return 0;
+	return resident * 4096.0 / (1024 * 1024);
+}
+
+// MB in 4K pages, that hold at least one of the shapes. The allocator can't
+// return these pages to the system, however little of them is used.
+template <class Poly>
+double pinned_mb(const vector<Poly>& shapes) {
+	vector<uintptr_t> pages;
+	pages.reserve(shapes.size());
+	for (auto& p : shapes) pages.push_back(reinterpret_cast<uintptr_t>(dynamic_cast<const void*>(p.get())) / 4096);
+	sort(pages.begin(), pages.end());
+	return (unique(pages.begin(), pages.end()) - pages.begin()) * 4096.0 / (1024 * 1024);
+}
+
+// Refills shapes up to n, with shapes of mixed sizes, then drops 90% of them
+// at random, for the given number of rounds. Calls after_round(round).
+template <class Poly, class F>
+void churn(vector<Poly>& shapes, size_t n, size_t rounds, F after_round) {
+	mt19937 gen(7);
+	for (size_t r = 0; r < rounds; ++r) {
+		while (shapes.size() < n) {
+			switch (gen() % 4) {
+			case 0: shapes.push_back(pl::make<Poly, Padded_Square<8>>(1.0)); break;
+			case 1: shapes.push_back(pl::make<Poly, Padded_Square<40>>(1.0)); break;
+			case 2: shapes.push_back(pl::make<Poly, Padded_Square<104>>(1.0)); break;
+			default: shapes.push_back(pl::make<Poly, Padded_Square<232>>(1.0)); break;
+			}
+		}
+		shuffle(shapes.begin(), shapes.end(), gen);
+		shapes.resize(n / 10);
+		after_round(r);
+	}
+}
+
+// Makes and destroys n shapes of four sizes in total, split between threads.
+// Every thread keeps a window of live shapes, and replaces one of them per
+// step. Returns the time in ms.
+template <class Poly>
+double time_make_destroy(size_t threads, size_t n) {
+	return time_threads(threads, [&](size_t) {
+		vector<Poly> window(64);
+		for (size_t i = 0; i < n / threads; ++i) {
+			Poly& p = window[i % window.size()];
+			switch ((i + i / window.size()) % 4) {
+			case 0: p = pl::make<Poly, Virtual_Square>(1.0); break;
+			case 1: p = pl::make<Poly, Virtual_Circle>(1.0); break;
+			case 2: p = pl::make<Poly, Padded_Square<40>>(1.0); break;
+			default: p = pl::make<Poly, Padded_Square<104>>(1.0); break;
+			}
+		}
+	});
+}
+
+// A binary tree node, also used as a chain link, copied and destroyed
+// through Policy
+template <template <class> class Policy>
+struct Tree {
+	using ptr = poly<Tree, Policy<Tree>>;
+
+	ptr left;
+	ptr right;
+
+	virtual ~Tree() = default;
+};
+
+template <class T>
+using iterative_plain = pl::iterative<T>;
+
+template <class T>
+using iterative_memo = pl::iterative<T, true>;
+
+template <template <class> class Policy>
+typename Tree<Policy>::ptr make_tree(int depth) {
+	auto rslt = pl::make<typename Tree<Policy>::ptr, Tree<Policy>>();
+	if (depth > 1) {
+		rslt->left = make_tree<Policy>(depth - 1);
+		rslt->right = make_tree<Policy>(depth - 1);
+	}
+	return rslt;
+}
+
+template <template <class> class Policy>
+typename Tree<Policy>::ptr make_chain(size_t length) {
+	typename Tree<Policy>::ptr rslt;
+	for (size_t i = 0; i < length; ++i) {
+		auto link = pl::make<typename Tree<Policy>::ptr, Tree<Policy>>();
+		link->left = std::move(rslt);
+		rslt = std::move(link);
+	}
+	return rslt;
+}
+
+// Returns the times in ms to copy and to destroy a 1M node tree, and to copy
+// a 10K link chain 100 times
+template <template <class> class Policy>
+vector<double> time_tree_copies() {
+	auto tree = make_tree<Policy>(20);
+	auto chain = make_chain<Policy>(10000);
+	typename Tree<Policy>::ptr copy;
+
+	vector<double> rslt;
+	rslt.push_back(time_ms([&] { copy = tree; }));
+	rslt.push_back(time_ms([&] { copy.reset(); }));
+	rslt.push_back(time_ms([&] {
+		for (int i = 0; i < 100; ++i) copy = chain;
+	}));
+	return rslt;
+}
+
+#ifdef POLY_SHARED_MEMORY
+// MB in pages, that only this process maps, or 0 where
+// /proc/self/smaps_rollup is not available. Pages, inherited through fork(),
+// are shared until they are written to.
+double private_mb() {
+	ifstream smaps("/proc/self/smaps_rollup");
+	string line;
+	double kb = 0;
+	while (getline(smaps, line)) {
+		if (line.compare(0, 8, "Private_") == 0) kb += stod(line.substr(line.find(':') + 1));
+	}
+	return kb / 1024;
+}
+
+// Forks workers, that run f, and returns MB of memory, that became private
+// to them while f ran, summed over all workers
+template <class F>
+double fork_workers(size_t workers, F f) {
+	pl::shared_arena results(workers * sizeof(double));
+	double* slots = static_cast<double*>(results.allocate(workers * sizeof(double)));
+
+	// Reading smaps allocates, which lets malloc consolidate its free lists in
+	// the parent. Otherwise every worker does it, and copies most of the heap.
+	private_mb();
+
+	vector<pid_t> pids;
+	for (size_t w = 0; w < workers; ++w) {
+		pid_t pid = fork();
+		if (pid == 0) {
+			double before = private_mb();
+			f();
+			slots[w] = private_mb() - before;
+			_exit(0);
+		}
+		pids.push_back(pid);
+	}
+	for (pid_t pid : pids) waitpid(pid, nullptr, 0);
+
+	double rslt = 0;
+	for (size_t w = 0; w < workers; ++w) rslt += slots[w];
+	return rslt;
+}
+#endif
+
+// Sums the areas of all shapes
+template <class Poly>
+double sum_areas(const vector<Poly>& shapes) {
+	double sum = 0;
+	for (auto& p : shapes) sum += p->area();
+	return sum;
+}
+
+} // namespace
+
+void Benchmarker::print_benchmark_result(const std::string& name, double value, const std::string& unit) {
+	string spacer(80 - 15 - (name.size() < 65 ? name.size() : 0), ' ');
+	cerr << name << (name.size() >= 65 ? "\n" : "") <<
+		spacer << setw(10) << fixed << setprecision(2) << value << " " << unit << endl;
+}
+
+void Benchmarker::run() {
+	const size_t n = 1000000;
+
+	// slim vs deep ============================================================
+	{
+		auto deep = make_population<poly<Base, pl::deep<Base>>>(n);
+		auto slim = make_population<poly<Base, pl::slim<Base>>>(n);
+
+		print_benchmark_result("deep: vector<poly> memory, excluding objects",
+			n * sizeof(deep[0]) / 1024.0 / 1024.0, "MiB");
+		print_benchmark_result("slim: vector<poly> memory, excluding objects",
+			n * sizeof(slim[0]) / 1024.0 / 1024.0, "MiB");
+
+		print_benchmark_result("deep: copy vector<poly>", time_ms([&] {
+			auto copy = deep;
+		}), "ms");
+		print_benchmark_result("slim: copy vector<poly>", time_ms([&] {
+			auto copy = slim;
+		}), "ms");
+	}
+
+	// dispatch vs nested is<T>() ==============================================
+	{
+		using types = pl::type_list<Der, Mid1, Mid2, Mid3>;
+		vector<poly<Base>> objects;
+		for (size_t i = 0; i < 1024; ++i) {
+			switch (i * 7 % 4) {
+			case 0: objects.push_back(pl::make<poly<Base>, Der>()); break;
+			case 1: objects.push_back(pl::make<poly<Base>, Mid1>()); break;
+			case 2: objects.push_back(pl::make<poly<Base>, Mid2>()); break;
+			case 3: objects.push_back(pl::make<poly<Base>, Mid3>()); break;
+			}
+		}
+
+		long long sum1 = 0;
+		long long sum2 = 0;
+		print_benchmark_result("nested is<T>(): 1M pairs", time_ms([&] {
+			for (size_t i = 0; i < n; ++i) {
+				sum1 += nested_score(objects[i % 1024], objects[i * 31 % 1024]);
+			}
+		}), "ms");
+		print_benchmark_result("dispatch: 1M pairs", time_ms([&] {
+			for (size_t i = 0; i < n; ++i) {
+				sum2 += pl::dispatch<types, types>(
+					objects[i % 1024], objects[i * 31 % 1024], Pair_Score());
+			}
+		}), "ms");
+		if (sum1 != sum2) cerr << "dispatch: results differ" << endl;
+	}
+
+	// parallel make and destroy ===============================================
+	{
+		pl::factory<Base> f;
+		f.insert<Der>();
+		f.insert<Mid1>();
+		f.insert<Mid2>();
+
+		vector<string> names(n);
+		for (size_t i = 0; i < n; ++i) {
+			switch (i % 3) {
+			case 0: names[i] = typeid(Der).name(); break;
+			case 1: names[i] = typeid(Mid1).name(); break;
+			case 2: names[i] = typeid(Mid2).name(); break;
+			}
+		}
+
+		vector<poly<Base>> objects(n);
+		print_benchmark_result("make: 1M objects, sequential", time_ms([&] {
+			for (size_t i = 0; i < n; ++i) objects[i] = f.make(names[i]);
+		}), "ms");
+		print_benchmark_result("destroy: 1M objects, sequential", time_ms([&] {
+			for (auto& p : objects) p.reset();
+		}), "ms");
+
+		size_t max_threads = std::max(1u, std::thread::hardware_concurrency());
+		for (size_t threads = 1; threads <= max_threads; threads *= 2) {
+			pl::thread_pool pool(threads);
+			print_benchmark_result("parallel_make: 1M objects, " + to_string(threads) + " threads", time_ms([&] {
+				pl::parallel_make(f, names, objects.begin(), pool);
+			}), "ms");
+			print_benchmark_result("parallel_destroy: 1M objects, " + to_string(threads) + " threads", time_ms([&] {
+				pl::parallel_destroy(objects, pool);
+			}), "ms");
+		}
+	}
+
+	// parallel algorithms =====================================================
+	{
+		auto objects = make_population<poly<Base>>(n);
+		shuffle(objects.begin(), objects.end(), mt19937(42));
+
+		size_t sum = 0;
+		print_benchmark_result("transform_reduce: sequential, virtual", time_ms([&] {
+			for (auto& p : objects) sum += p->name().size();
+		}), "ms");
+		print_benchmark_result("par::transform_reduce: bucketed, virtual", time_ms([&] {
+			sum += pl::par::transform_reduce(objects, size_t(0), plus<size_t>(),
+				[](Base& x) { return x.name().size(); });
+		}), "ms");
+		print_benchmark_result("par::transform_reduce: bucketed, typed", time_ms([&] {
+			sum += pl::par::transform_reduce<pl::type_list<Der, Mid1, Mid2>>(
+				objects, size_t(0), plus<size_t>(), Name_Length());
+		}), "ms");
+		if (sum % 3 != 0) cerr << "transform_reduce: results differ" << endl;
+	}
+
+	// deferred delete =========================================================
+	{
+		using deferred_poly = poly<Base,
+			pl::compound<pl::deep_copy<Base>, pl::deferred_delete<Base>>>;
+		const size_t count = 5000;
+
+		vector<poly<Base>> objects1;
+		vector<deferred_poly> objects2;
+		for (size_t i = 0; i < count; ++i) {
+			objects1.push_back(pl::make<poly<Base>, Heavy>());
+			objects2.push_back(pl::make<deferred_poly, Heavy>());
+		}
+
+		auto latencies1 = reset_latencies(objects1);
+		pl::default_reclaimer().start();
+		auto latencies2 = reset_latencies(objects2);
+		pl::default_reclaimer().stop();
+		pl::drain();
+
+		print_benchmark_result("reset: default_delete, p50", percentile(latencies1, 0.5), "us");
+		print_benchmark_result("reset: default_delete, p99", percentile(latencies1, 0.99), "us");
+		print_benchmark_result("reset: default_delete, p999", percentile(latencies1, 0.999), "us");
+		print_benchmark_result("reset: deferred_delete, p50", percentile(latencies2, 0.5), "us");
+		print_benchmark_result("reset: deferred_delete, p99", percentile(latencies2, 0.99), "us");
+		print_benchmark_result("reset: deferred_delete, p999", percentile(latencies2, 0.999), "us");
+	}
+
+	// atomic_poly vs mutex ====================================================
+	{
+		const size_t reads = 1000000;
+		size_t max_threads = std::max<size_t>(4, std::thread::hardware_concurrency());
+
+		pl::atomic_poly<Base> shared(pl::make<poly<Base>, Mid1>());
+		poly<Base> locked = pl::make<poly<Base>, Mid1>();
+		mutex lock;
+
+		for (size_t threads = 1; threads <= max_threads; threads *= 2) {
+			atomic<size_t> sum(0);
+			print_benchmark_result("mutex<poly>: 1M reads per thread, " + to_string(threads) + " threads",
+				time_threads(threads, [&](size_t) {
+					size_t local = 0;
+					for (size_t i = 0; i < reads; ++i) {
+						lock_guard<mutex> guard(lock);
+						local += locked->name().size();
+					}
+					sum += local;
+				}), "ms");
+			print_benchmark_result("atomic_poly: 1M reads per thread, " + to_string(threads) + " threads",
+				time_threads(threads, [&](size_t) {
+					size_t local = 0;
+					for (size_t i = 0; i < reads; ++i) {
+						local += shared.load()->name().size();
+					}
+					sum += local;
+				}), "ms");
+		}
+	}
+
+	// lazy_poly ===============================================================
+	{
+		const size_t count = 10000;
+		pl::factory<Base> f;
+		f.insert<Heavy>();
+
+		print_benchmark_result("factory: make 10k components eagerly", time_ms([&] {
+			vector<poly<Base>> components;
+			for (size_t i = 0; i < count; ++i) components.push_back(f.make(typeid(Heavy).name()));
+		}), "ms");
+		print_benchmark_result("lazy_poly: declare 10k components, touch 1%", time_ms([&] {
+			vector<pl::lazy_poly<Base>> components;
+			for (size_t i = 0; i < count; ++i) components.emplace_back(f, typeid(Heavy).name());
+			for (size_t i = 0; i < count; i += 100) components[i]->name();
+		}), "ms");
+
+		pl::lazy_poly<Base> lazy(f, typeid(Mid1).name());
+		poly<Base> eager = pl::make<poly<Base>, Mid1>();
+		f.insert<Mid1>();
+		size_t sum = 0;
+		print_benchmark_result("poly: 1M accesses", time_ms([&] {
+			for (size_t i = 0; i < n; ++i) sum += eager->name().size();
+		}), "ms");
+		print_benchmark_result("lazy_poly: 1M accesses after construction", time_ms([&] {
+			for (size_t i = 0; i < n; ++i) sum += lazy->name().size();
+		}), "ms");
+		if (sum != 8 * n) cerr << "lazy_poly: results differ" << endl;
+	}
+
+	// factory prototypes ======================================================
+	{
+		const size_t count = 10000;
+		pl::factory<Base> f;
+		f.insert<Table>();
+
+		auto prototype = pl::make<poly<Base>, Table>();
+		prototype.as<Table>()->scale = 2;
+		f.insert_prototype("scaled table", prototype);
+
+		print_benchmark_result("factory: make 10k objects, then configure", time_ms([&] {
+			for (size_t i = 0; i < count; ++i) {
+				auto p = f.make(typeid(Table).name());
+				p.as<Table>()->scale = 2;
+			}
+		}), "ms");
+		print_benchmark_result("factory: make 10k objects from a prototype", time_ms([&] {
+			for (size_t i = 0; i < count; ++i) {
+				auto p = f.make("scaled table");
+			}
+		}), "ms");
+	}
+
+	// factory handles =========================================================
+	{
+		pl::factory<Base> f;
+		f.insert<Der>();
+		f.insert<Mid1>();
+		f.insert<Mid2>();
+		f.insert<Mid3>();
+
+		vector<string> names{typeid(Der).name(), typeid(Mid1).name(),
+			typeid(Mid2).name(), typeid(Mid3).name()};
+		vector<pl::factory<Base>::handle> ids(names.size());
+		f.id_of(names.begin(), names.end(), ids.begin());
+
+		size_t sum = 0;
+		print_benchmark_result("factory: 1M make(name)", time_ms([&] {
+			for (size_t i = 0; i < n; ++i) sum += f.make(names[i % 4]) ? 1 : 0;
+		}), "ms");
+		print_benchmark_result("factory: 1M make(handle)", time_ms([&] {
+			for (size_t i = 0; i < n; ++i) sum += f.make(ids[i % 4]) ? 1 : 0;
+		}), "ms");
+		if (sum != 2 * n) cerr << "factory: results differ" << endl;
+	}
+
+	// casts to any base =======================================================
+	{
+		poly<Mid1> p = pl::make<poly<Mid1>, Der>();
+		size_t sum = 0;
+		print_benchmark_result("dynamic_cast: 1M side casts in a diamond", time_ms([&] {
+			for (size_t i = 0; i < n; ++i) sum += dynamic_cast<Mid2*>(p.get()) ? 1 : 0;
+		}), "ms");
+		print_benchmark_result("poly: 1M side casts in a diamond with as_base", time_ms([&] {
+			for (size_t i = 0; i < n; ++i) sum += p.as_base<Mid2>() ? 1 : 0;
+		}), "ms");
+		if (sum != 2 * n) cerr << "as_base: results differ" << endl;
+	}
+
+	// any_of ==================================================================
+	{
+		using Shape = pl::any_of<pl::type_list<Area>>;
+		vector<poly<Shape_Base>> virtual_shapes;
+		vector<Shape> shapes;
+		virtual_shapes.reserve(n);
+		shapes.reserve(n);
+
+		print_benchmark_result("poly: make 1M shapes", time_ms([&] {
+			for (size_t i = 0; i < n; ++i) {
+				if (i % 2) virtual_shapes.push_back(pl::make<poly<Shape_Base>, Virtual_Square>(1.0));
+				else virtual_shapes.push_back(pl::make<poly<Shape_Base>, Virtual_Circle>(1.0));
+			}
+		}), "ms");
+		print_benchmark_result("any_of: make 1M shapes", time_ms([&] {
+			for (size_t i = 0; i < n; ++i) {
+				if (i % 2) shapes.push_back(Square{1.0});
+				else shapes.push_back(Circle{1.0});
+			}
+		}), "ms");
+
+		double sum1 = 0;
+		double sum2 = 0;
+		print_benchmark_result("poly: sum areas of 1M shapes", time_ms([&] {
+			for (auto& p : virtual_shapes) sum1 += p->area();
+		}), "ms");
+		print_benchmark_result("any_of: sum areas of 1M shapes", time_ms([&] {
+			for (auto& s : shapes) sum2 += s.call<Area>();
+		}), "ms");
+		if (sum1 != sum2) cerr << "any_of: results differ" << endl;
+	}
+
+	// bound methods ===========================================================
+	{
+		using Types = pl::type_list<Virtual_Square, Virtual_Circle>;
+		auto single = pl::make<poly<Shape_Base>, Virtual_Square>(1.0);
+		auto single_area = pl::bound<Exact_Area, Types>(single);
+
+		double sum1 = 0;
+		double sum2 = 0;
+		print_benchmark_result("poly: 10M virtual calls on one object", time_ms([&] {
+			for (size_t i = 0; i < 10 * n; ++i) sum1 += single->area();
+		}), "ms");
+		print_benchmark_result("poly: 10M bound calls on one object", time_ms([&] {
+			for (size_t i = 0; i < 10 * n; ++i) sum2 += single_area();
+		}), "ms");
+		if (sum1 != sum2) cerr << "bound: results differ" << endl;
+
+		vector<poly<Shape_Base>> shapes;
+		shapes.reserve(n);
+		for (size_t i = 0; i < n; ++i) {
+			if (i % 2) shapes.push_back(pl::make<poly<Shape_Base>, Virtual_Square>(1.0));
+			else shapes.push_back(pl::make<poly<Shape_Base>, Virtual_Circle>(1.0));
+		}
+		vector<pl::bound_method<Exact_Area>> areas;
+		areas.reserve(n);
+		for (auto& p : shapes) areas.push_back(pl::bound<Exact_Area, Types>(p));
+
+		sum1 = 0;
+		sum2 = 0;
+		print_benchmark_result("poly: virtual calls over 1M objects", time_ms([&] {
+			for (auto& p : shapes) sum1 += p->area();
+		}), "ms");
+		print_benchmark_result("poly: bound calls over 1M objects", time_ms([&] {
+			for (auto& area : areas) sum2 += area();
+		}), "ms");
+		if (sum1 != sum2) cerr << "bound: results differ" << endl;
+	}
+
+	// relocation ==============================================================
+	{
+		vector<poly<Base>> std_vector;
+		pl::vector<poly<Base>> pl_vector;
+		auto p = pl::make<poly<Base>, Mid1>();
+
+		auto source1 = make_population<poly<Base>>(n);
+		auto source2 = make_population<poly<Base>>(n);
+		print_benchmark_result("std::vector: push_back 1M polys", time_ms([&] {
+			for (auto& x : source1) std_vector.push_back(std::move(x));
+		}), "ms");
+		print_benchmark_result("pl::vector: push_back 1M polys", time_ms([&] {
+			for (auto& x : source2) pl_vector.push_back(std::move(x));
+		}), "ms");
+
+		const size_t count = 20000;
+		std_vector.clear();
+		pl_vector.clear();
+		std_vector.shrink_to_fit();
+		print_benchmark_result("std::vector: insert 20k polys in the middle", time_ms([&] {
+			for (size_t i = 0; i < count; ++i) {
+				std_vector.insert(std_vector.begin() + std_vector.size() / 2, p);
+			}
+		}), "ms");
+		print_benchmark_result("pl::vector: insert 20k polys in the middle", time_ms([&] {
+			for (size_t i = 0; i < count; ++i) {
+				pl_vector.insert(pl_vector.begin() + pl_vector.size() / 2, p);
+			}
+		}), "ms");
+	}
+
+	// intern_pool =============================================================
+	{
+		const size_t distinct = 1000;
+		const double record_bytes = sizeof(Record) + 32 * sizeof(int);
+		pl::intern_pool<Base, Record_Hash, Record_Equal> pool;
+		vector<shared_ptr<const Base>> handles;
+		handles.reserve(n);
+
+		print_benchmark_result("intern_pool: intern 1M records, 1000 distinct", time_ms([&] {
+			for (size_t i = 0; i < n; ++i) {
+				handles.push_back(pool.intern(
+					pl::make<poly<Base>, Record>(static_cast<int>(i % distinct))));
+			}
+		}), "ms");
+
+		// Estimated from object sizes, without allocator overhead. A canonical
+		// object also costs about 64 bytes for its node, slot and control block.
+		double plain = n * (sizeof(poly<const Base>) + record_bytes);
+		double interned = n * sizeof(shared_ptr<const Base>) +
+			pool.size() * (record_bytes + 64);
+		print_benchmark_result("intern_pool: memory of 1M records, not interned", plain / 1e6, "MB");
+		print_benchmark_result("intern_pool: memory of 1M records, interned", interned / 1e6, "MB");
+		print_benchmark_result("intern_pool: memory saved", (plain - interned) / 1e6, "MB");
+	}
+
+	// inline_cache ============================================================
+	{
+		using Types = pl::type_list<
+			Virtual_Square, Virtual_Circle, Virtual_Triangle, Virtual_Hexagon>;
+		const double shares[] = {0.95, 0.25};
+		const char* names[] = {"skewed", "uniform"};
+
+		for (int mix = 0; mix < 2; ++mix) {
+			auto shapes = make_shapes(n, shares[mix]);
+			pl::inline_cache<Shape_Base, 2, Types> cache;
+			double sum1 = 0;
+			double sum2 = 0;
+
+			print_benchmark_result(string("poly: virtual calls, 1M ") + names[mix] + " shapes", time_ms([&] {
+				for (auto& p : shapes) sum1 += p->area();
+			}), "ms");
+			print_benchmark_result(string("inline_cache: calls, 1M ") + names[mix] + " shapes", time_ms([&] {
+				for (auto& p : shapes) sum2 += cache(p, Area_Handler());
+			}), "ms");
+			print_benchmark_result(string("inline_cache: hit rate, ") + names[mix] + " shapes",
+				100 * cache.hit_rate(), "%");
+			if (sum1 != sum2) cerr << "inline_cache: results differ" << endl;
+		}
+	}
+
+	// aligned policy ==========================================================
+	{
+		const size_t threads = 4;
+		print_benchmark_result("poly: 4 threads, 10M increments each",
+			time_workers<poly<Base>>(threads, 10 * n), "ms");
+		print_benchmark_result("poly (aligned): 4 threads, 10M increments each",
+			time_workers<poly<Base, pl::aligned<Base>>>(threads, 10 * n), "ms");
+	}
+
+	// factory layouts =========================================================
+	{
+		pl::factory<Base> f;
+		f.insert<Mid1>();
+		f.insert<Mid2>();
+		auto id = f.id_of(typeid(Mid1).name());
+
+		vector<unsigned char> storage(f.max_size() + f.max_align());
+		void* memory = storage.data();
+		size_t space = storage.size();
+		std::align(f.max_align(), f.max_size(), memory, space);
+
+		size_t sum = 0;
+		print_benchmark_result("factory: 1M make(handle) on the heap", time_ms([&] {
+			for (size_t i = 0; i < n; ++i) sum += f.make(id)->base_name.size();
+		}), "ms");
+		print_benchmark_result("factory: 1M construct_at(handle) in a buffer", time_ms([&] {
+			for (size_t i = 0; i < n; ++i) sum += f.construct_at(id, memory)->base_name.size();
+		}), "ms");
+		if (sum != 8 * n) cerr << "factory: results differ" << endl;
+	}
+
+	// tagged_vector ===========================================================
+	{
+		// Shuffled, so that objects are not visited in the order of allocation
+		auto shapes = make_shapes(n, 0.25);
+		shuffle(shapes.begin(), shapes.end(), mt19937(7));
+
+		pl::tagged_vector<Shape_Base> tagged;
+		tagged.reserve(shapes.size());
+		for (auto& p : shapes) tagged.push_back(p);
+
+		size_t count1 = 0;
+		size_t count2 = 0;
+		print_benchmark_result("poly: count is<T>() in 1M shapes", time_ms([&] {
+			for (auto& p : shapes) count1 += p.is<Virtual_Square>();
+		}), "ms");
+		print_benchmark_result("tagged_vector: count<T>() in 1M shapes", time_ms([&] {
+			count2 = tagged.count<Virtual_Square>();
+		}), "ms");
+
+		vector<size_t> found1;
+		vector<size_t> found2;
+		found1.reserve(n);
+		found2.reserve(n);
+		print_benchmark_result("poly: find indices of T in 1M shapes", time_ms([&] {
+			for (size_t i = 0; i < shapes.size(); ++i) {
+				if (shapes[i].is<Virtual_Square>()) found1.push_back(i);
+			}
+		}), "ms");
+		print_benchmark_result("tagged_vector: find_all<T>() in 1M shapes", time_ms([&] {
+			tagged.find_all<Virtual_Square>(back_inserter(found2));
+		}), "ms");
+
+		print_benchmark_result("poly: stable_partition by is<T>() of 1M shapes", time_ms([&] {
+			stable_partition(shapes.begin(), shapes.end(),
+				[](const poly<Shape_Base>& p) { return p.is<Virtual_Square>(); });
+		}), "ms");
+		print_benchmark_result("tagged_vector: partition<T>() of 1M shapes", time_ms([&] {
+			tagged.partition<Virtual_Square>();
+		}), "ms");
+		if (count1 != count2 || found1 != found2) cerr << "tagged_vector: results differ" << endl;
+	}
+
+	// poly_slot_map ===========================================================
+	{
+		auto shapes = make_shapes(n, 0.25);
+		pl::poly_slot_map<Shape_Base> slots;
+		unordered_map<size_t, poly<Shape_Base>> by_id;
+		vector<pl::poly_slot_map<Shape_Base>::handle> handles;
+		handles.reserve(n);
+		by_id.reserve(n);
+		for (size_t i = 0; i < shapes.size(); ++i) {
+			handles.push_back(slots.insert(shapes[i]));
+			by_id.emplace(i, shapes[i]);
+		}
+
+		// Every other element is erased, and lookups are made in random order
+		for (size_t i = 0; i < n; i += 2) {
+			slots.erase(handles[i]);
+			by_id.erase(i);
+		}
+		vector<size_t> order(n);
+		for (size_t i = 0; i < n; ++i) order[i] = i;
+		shuffle(order.begin(), order.end(), mt19937(3));
+		vector<pl::poly_slot_map<Shape_Base>::handle> lookups;
+		lookups.reserve(n);
+		for (size_t i : order) lookups.push_back(handles[i]);
+
+		double sum1 = 0;
+		double sum2 = 0;
+		print_benchmark_result("unordered_map: iterate 500K shapes", time_ms([&] {
+			for (auto& kv : by_id) sum1 += kv.second->area();
+		}), "ms");
+		print_benchmark_result("poly_slot_map: iterate 500K shapes", time_ms([&] {
+			for (auto& p : slots) sum2 += p->area();
+		}), "ms");
+		print_benchmark_result("unordered_map: 1M lookups, half missing", time_ms([&] {
+			for (size_t i : order) {
+				auto it = by_id.find(i);
+				if (it != by_id.end()) sum1 += it->second->area();
+			}
+		}), "ms");
+		print_benchmark_result("poly_slot_map: 1M lookups, half stale", time_ms([&] {
+			for (auto h : lookups) {
+				if (auto p = slots.find(h)) sum2 += (*p)->area();
+			}
+		}), "ms");
+		if (abs(sum1 - sum2) > 1e-6 * abs(sum1)) cerr << "poly_slot_map: results differ" << endl;
+	}
+
+	// poly_queue ==============================================================
+	{
+		const size_t configs[][2] = {{1, 1}, {2, 2}, {4, 4}};
+		for (auto& config : configs) {
+			size_t producers = config[0];
+			size_t consumers = config[1];
+			string threads = to_string(producers) + "P/" + to_string(consumers) + "C";
+			double latency = 0;
+
+			Locked_Queue locked;
+			print_benchmark_result("mutex + deque: 1M messages, " + threads,
+				time_pipeline(locked, producers, consumers, n, latency), "ms");
+			print_benchmark_result("mutex + deque: mean latency, " + threads, latency, "us");
+
+			pl::poly_queue<Timed_Message> mpmc_queue(1024);
+			print_benchmark_result("poly_queue (mpmc): 1M messages, " + threads,
+				time_pipeline(mpmc_queue, producers, consumers, n, latency), "ms");
+			print_benchmark_result("poly_queue (mpmc): mean latency, " + threads, latency, "us");
+
+			if (producers == 1 && consumers == 1) {
+				pl::poly_queue<Timed_Message, pl::unique<Timed_Message>, pl::spsc> spsc_queue(1024);
+				print_benchmark_result("poly_queue (spsc): 1M messages, " + threads,
+					time_pipeline(spsc_queue, producers, consumers, n, latency), "ms");
+				print_benchmark_result("poly_queue (spsc): mean latency, " + threads, latency, "us");
+			}
+		}
+	}
+
+	// compacting arena ========================================================
+	{
+		using Compact = poly<Shape_Base, pl::compacting<Shape_Base>>;
+		const size_t shapes = n / 2;
+		const size_t rounds = 4;
+		auto& arena = pl::default_arena<Shape_Base>();
+
+		double baseline = rss_mb();
+		vector<poly<Shape_Base>> heap_shapes;
+		churn(heap_shapes, shapes, rounds, [&](size_t r) {
+			string round = to_string(r + 1);
+			print_benchmark_result("heap: RSS growth after churn round " + round, rss_mb() - baseline, "MB");
+			print_benchmark_result("heap: pages with survivors after round " + round, pinned_mb(heap_shapes), "MB");
+		});
+		double sum1 = 0;
+		print_benchmark_result("heap: iterate 50K survivors",
+			time_ms([&] { sum1 = sum_areas(heap_shapes); }), "ms");
+		heap_shapes = vector<poly<Shape_Base>>();
+
+		baseline = rss_mb();
+		vector<Compact> arena_shapes;
+		double compact_time = 0;
+		size_t steps = 0;
+		churn(arena_shapes, shapes, rounds, [&](size_t r) {
+			// Compact in steps of 1 ms, as a frame loop would
+			compact_time += time_ms([&] {
+				while (!arena.compact(chrono::milliseconds(1))) ++steps;
+				++steps;
+			});
+			string round = to_string(r + 1);
+			print_benchmark_result("compacting arena: RSS growth after churn round " + round,
+				rss_mb() - baseline, "MB");
+			print_benchmark_result("compacting arena: pages with survivors after round " + round,
+				pinned_mb(arena_shapes), "MB");
+		});
+		double sum2 = 0;
+		print_benchmark_result("compacting arena: iterate 50K survivors",
+			time_ms([&] { sum2 = sum_areas(arena_shapes); }), "ms");
+		print_benchmark_result("compacting arena: total compaction time", compact_time, "ms");
+		print_benchmark_result("compacting arena: 1 ms compaction steps", static_cast<double>(steps), "");
+		print_benchmark_result("compacting arena: live / capacity",
+			100.0 * arena.live() / arena.capacity(), "%");
+		if (sum1 != sum2) cerr << "compacting arena: results differ" << endl;
+	}
+
+	// factory bulk insertion ==================================================
+	{
+		using Factory = pl::factory<Base>;
+		auto prototype = pl::make<poly<Base>, Mid1>();
+
+		for (size_t count : {1000, 10000, 100000}) {
+			// Plugins register their types in no particular order
+			vector<string> names;
+			for (size_t i = 0; i < count; ++i) names.push_back("plugin type " + to_string(i));
+			shuffle(names.begin(), names.end(), mt19937(5));
+			string types = to_string(count / 1000) + "k types";
+
+			Factory f1;
+			print_benchmark_result("factory: insert " + types + " one by one", time_ms([&] {
+				for (auto& name : names) f1.insert_prototype(name, prototype);
+			}), "ms");
+
+			Factory f2;
+			print_benchmark_result("factory: bulk_insert " + types, time_ms([&] {
+				vector<Factory::registration> batch;
+				batch.reserve(count);
+				for (auto& name : names) batch.push_back(Factory::registration(name, prototype));
+				f2.bulk_insert(make_move_iterator(batch.begin()), make_move_iterator(batch.end()));
+			}), "ms");
+			if (f1.list() != f2.list()) cerr << "factory: bulk insertion differs" << endl;
+		}
+	}
+
+	// recycling policy ========================================================
+	{
+		using Recycled = poly<Shape_Base, pl::recycling<Shape_Base>>;
+		for (size_t threads : {1, 2, 4}) {
+			string config = "1M shapes, " + to_string(threads) + " threads";
+			print_benchmark_result("new/delete: make and destroy " + config,
+				time_make_destroy<poly<Shape_Base>>(threads, n), "ms");
+			print_benchmark_result("recycling: make and destroy " + config,
+				time_make_destroy<Recycled>(threads, n), "ms");
+		}
+
+		// Objects, destroyed on another thread, go through the remote list
+		vector<poly<Shape_Base>> heap_shapes = make_shapes(n, 0.25);
+		print_benchmark_result("new/delete: destroy 1M shapes on another thread",
+			time_threads(1, [&](size_t) { heap_shapes.clear(); }), "ms");
+
+		vector<Recycled> recycled_shapes;
+		recycled_shapes.reserve(n);
+		for (size_t i = 0; i < n; ++i) recycled_shapes.push_back(pl::make<Recycled, Virtual_Square>(1.0));
+		print_benchmark_result("recycling: destroy 1M shapes on another thread",
+			time_threads(1, [&](size_t) { recycled_shapes.clear(); }), "ms");
+
+		pl::recycling_statistics stats = pl::recycling_stats();
+		print_benchmark_result("recycling: hit rate", 100 * stats.hit_rate(), "%");
+		print_benchmark_result("recycling: remote frees", static_cast<double>(stats.remote_frees), "");
+	}
+
+	// iterative policy ========================================================
+	{
+		const pair<string, vector<double>> results[] = {
+			{"deep", time_tree_copies<pl::deep>()},
+			{"iterative", time_tree_copies<iterative_plain>()},
+			{"iterative with memo", time_tree_copies<iterative_memo>()}
+		};
+		for (auto& r : results) {
+			print_benchmark_result(r.first + ": copy a 1M node tree", r.second[0], "ms");
+			print_benchmark_result(r.first + ": destroy a 1M node tree", r.second[1], "ms");
+			print_benchmark_result(r.first + ": copy a 10K link chain 100 times", r.second[2], "ms");
+		}
+
+		// Too long for recursion
+		auto chain = make_chain<iterative_plain>(10 * n);
+		Tree<iterative_plain>::ptr copy;
+		print_benchmark_result("iterative: copy a 10M link chain", time_ms([&] { copy = chain; }), "ms");
+		print_benchmark_result("iterative: destroy a 10M link chain", time_ms([&] { copy.reset(); }), "ms");
+	}
+
+#ifdef POLY_SHARED_MEMORY
+	// shared_arena ============================================================
+	{
+		const size_t workers = 4;
+		const string names[] = {"square", "circle", "triangle", "hexagon"};
+		pl::factory<Shape_Base> f;
+		f.insert_prototype(names[0], pl::make<poly<Shape_Base>, Virtual_Square>(1.0));
+		f.insert_prototype(names[1], pl::make<poly<Shape_Base>, Virtual_Circle>(1.0));
+		f.insert_prototype(names[2], pl::make<poly<Shape_Base>, Virtual_Triangle>(1.0));
+		f.insert_prototype(names[3], pl::make<poly<Shape_Base>, Virtual_Hexagon>(1.0));
+
+		// Every worker makes its own shapes after fork()
+		double rebuilt = 0;
+		print_benchmark_result("factory: 4 workers make 1M shapes each", time_ms([&] {
+			rebuilt = fork_workers(workers, [&] {
+				vector<poly<Shape_Base>> shapes;
+				shapes.reserve(n);
+				for (size_t i = 0; i < n; ++i) shapes.push_back(f.make(names[i % 4]));
+				volatile double sum = sum_areas(shapes);
+				(void)sum;
+			});
+		}), "ms");
+
+		// The parent makes the shapes once, before fork(), and workers read them
+		using Shared = poly<const Shape_Base, pl::shared_memory<const Shape_Base>>;
+		pl::shared_arena arena(n * 64);
+		vector<Shared> shared_shapes;
+		print_benchmark_result("shared_arena: make 1M shapes before fork", time_ms([&] {
+			shared_shapes.reserve(n);
+			for (size_t i = 0; i < n; ++i) {
+				switch (i % 4) {
+				case 0: shared_shapes.push_back(pl::make<Shared, Virtual_Square>(arena, 1.0)); break;
+				case 1: shared_shapes.push_back(pl::make<Shared, Virtual_Circle>(arena, 1.0)); break;
+				case 2: shared_shapes.push_back(pl::make<Shared, Virtual_Triangle>(arena, 1.0)); break;
+				default: shared_shapes.push_back(pl::make<Shared, Virtual_Hexagon>(arena, 1.0)); break;
+				}
+			}
+		}), "ms");
+
+		double shared = 0;
+		print_benchmark_result("shared_arena: 4 workers read 1M shapes", time_ms([&] {
+			shared = fork_workers(workers, [&] {
+				volatile double sum = sum_areas(shared_shapes);
+				(void)sum;
+			});
+		}), "ms");
+
+		print_benchmark_result("factory: memory of 4 workers", rebuilt, "MB");
+		print_benchmark_result("shared_arena: memory of 4 workers", shared, "MB");
+		// Kept once, by the parent
+		print_benchmark_result("shared_arena: memory of shapes, made before fork",
+			(arena.used() + n * sizeof(Shared)) / (1024.0 * 1024), "MB");
+	}
+#endif
+}
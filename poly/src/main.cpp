@@ -2,8 +2,15 @@
 #include <string>
 #include <map>
 #include "tests.hpp"
+#include "benchmarks.hpp"
+
+int main(int argc, char* argv[]) {
+	if (argc > 1 && std::string(argv[1]) == "--bench") {
+		Benchmarker b;
+		b.run();
+		return 0;
+	}
 
-int main() {
 	Tester t;
 	t.run();
-}
\ No newline at end of file
+}
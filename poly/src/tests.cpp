@@ -1,12 +1,341 @@
 #include <iostream>
 #include <iomanip>
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <thread>
+#include <functional>
+#include <iterator>
+#include <memory>
+#include <vector>
 #include "tests.hpp"
 #include "poly.hpp"
 #include "factory.hpp"
+#include "dispatch.hpp"
+#include "parallel.hpp"
+#include "parallel_algorithm.hpp"
+#include "deferred_delete.hpp"
+#include "atomic_poly.hpp"
+#include "lazy_poly.hpp"
+#include "any_of.hpp"
+#include "bound_method.hpp"
+#include "vector.hpp"
+#include "intern_pool.hpp"
+#include "inline_cache.hpp"
+#include "tagged_vector.hpp"
+#include "poly_slot_map.hpp"
+#include "poly_queue.hpp"
+#include "shared_arena.hpp"
+
+#ifdef POLY_SHARED_MEMORY
+#include <sys/wait.h> // waitpid
+#include <unistd.h>   // fork, _exit
+#endif
 
 using pl::poly;
 using namespace std;
 
+namespace {
+
+struct Collide {
+	using result_type = std::string;
+
+	std::string operator()(Mid1&, Mid1&) { return "mid1-mid1"; }
+	std::string operator()(Mid1&, Mid2&) { return "mid1-mid2"; }
+	std::string operator()(const Der&, const Der&) { return "der-der"; }
+};
+
+struct Collide_Fallback {
+	std::string operator()(const Base&, const Base&) { return "fallback"; }
+};
+
+// Counts objects by name, statically for listed types
+struct Count_Names {
+	std::atomic<int>* mid1;
+	std::atomic<int>* other;
+
+	void operator()(Mid1& x) { if (x.name() == "mid1") ++*mid1; }
+	void operator()(Base&) { ++*other; }
+};
+
+struct Name_Length {
+	std::size_t operator()(Base& x) const { return x.name().size(); }
+};
+
+struct Is_Mid1 {
+	bool operator()(Mid1&) const { return true; }
+	bool operator()(Base&) const { return false; }
+};
+
+// Counts living instances
+struct Counted : Base {
+	static std::atomic<int> alive;
+
+	Counted() { ++alive; }
+	Counted(const Counted& other) : Base(other) { ++alive; }
+	~Counted() { --alive; }
+};
+
+std::atomic<int> Counted::alive(0);
+
+// Executor that runs tasks on the calling thread
+struct Inline_Executor {
+	void execute(std::function<void()> task) { task(); }
+};
+
+// Executor that runs up to limit tasks, a bit later, on threads of their
+// own, and throws when it is given more
+struct Limited_Executor {
+	std::size_t limit;
+	std::vector<std::thread> threads;
+
+	explicit Limited_Executor(std::size_t limit) : limit(limit) {}
+	~Limited_Executor() { for (auto& t : threads) t.join(); }
+
+	std::size_t size() const { return 2; }
+	void execute(std::function<void()> task) {
+		if (threads.size() == limit) throw std::runtime_error("Limited_Executor: full");
+		threads.emplace_back([task] {
+			std::this_thread::sleep_for(std::chrono::milliseconds(10));
+			task();
+		});
+	}
+};
+
+// An interface for any_of and types that implement it without a base class
+struct Area : pl::method<double() const> {
+	template <class T>
+	static double call(const T& shape) { return shape.area(); }
+};
+
+struct Scale : pl::method<void(double)> {
+	template <class T>
+	static void call(T& shape, double factor) { shape.scale(factor); }
+};
+
+using Shape = pl::any_of<pl::type_list<Area, Scale>>;
+
+struct Square {
+	double side;
+
+	double area() const { return side * side; }
+	void scale(double factor) { side *= factor; }
+};
+
+struct Polygon {
+	std::vector<double> sides;
+	std::unique_ptr<int> tag;
+
+	double area() const { return static_cast<double>(sides.size()); }
+	void scale(double) {}
+};
+
+struct Large_Square : Square {
+	char padding[64];
+};
+
+// A method for bound, that calls name() without virtual dispatch
+struct Exact_Name : pl::method<std::string()> {
+	template <class T>
+	static std::string call(T& x) { return x.T::name(); }
+};
+
+struct Name_Suffix : pl::method<std::string(const std::string&) const> {
+	template <class T>
+	static std::string call(const T& x, const std::string& suffix) {
+		return typeid(x).name() + suffix;
+	}
+};
+
+// Labels are equal if their texts are equal, for intern_pool
+struct Label : Base {
+	std::string text;
+
+	explicit Label(std::string text) : text(std::move(text)) {}
+};
+
+struct Label_Hash {
+	std::size_t operator()(const Base& x) const {
+		const Label* label = dynamic_cast<const Label*>(&x);
+		return label ? std::hash<std::string>()(label->text) : 0;
+	}
+};
+
+struct Label_Equal {
+	bool operator()(const Base& x, const Base& y) const {
+		const Label* label = dynamic_cast<const Label*>(&x);
+		return !label || label->text == static_cast<const Label&>(y).text;
+	}
+};
+
+// Tells which overload was called, for inline_cache
+struct Which_Overload {
+	using result_type = std::string;
+
+	std::string operator()(Der&) const { return "der"; }
+	std::string operator()(Mid1&) const { return "mid1"; }
+	std::string operator()(Base& x) const { return "virtual " + x.name(); }
+};
+
+// A type with an alignment, stronger than a cache line
+struct alignas(128) Over_Aligned : Base {
+	char data[8];
+};
+
+// Checks that the most derived object of p is aligned to align
+template <class PolyType>
+bool is_aligned(const PolyType& p, std::size_t align) {
+	return reinterpret_cast<std::uintptr_t>(dynamic_cast<const void*>(p.get())) % align == 0;
+}
+
+// A message with its producer and position, for poly_queue
+struct Sequenced : Base {
+	int producer;
+	int number;
+
+	Sequenced(int producer, int number) : producer(producer), number(number) {}
+};
+
+// Output iterator that appends to a vector, and throws instead of appending
+// the value number left
+template <class T>
+struct Throwing_Output {
+	std::vector<T>* out;
+	int left;
+
+	Throwing_Output& operator*() { return *this; }
+	Throwing_Output& operator++(int) { return *this; }
+	Throwing_Output& operator=(T&& value) {
+		if (left-- == 0) throw std::runtime_error("Throwing_Output: full");
+		out->push_back(std::move(value));
+		return *this;
+	}
+};
+
+// Owns an object in the compacting arena, for compacting_arena
+struct Holder : Base {
+	poly<Base, pl::compacting<Base>> child;
+
+	explicit Holder(poly<Base, pl::compacting<Base>> child) : child(std::move(child)) {}
+};
+
+// A type, too large for the slabs of the recycling policy
+struct Large : Base {
+	char data[2048];
+};
+
+// Links of a Self_Ptr chain: one counts its objects, the other can't be copied
+struct Counted_Link : Self_Ptr {
+	static int alive;
+
+	Counted_Link() { ++alive; }
+	Counted_Link(const Counted_Link& other) : Self_Ptr(other) { ++alive; }
+	~Counted_Link() { --alive; }
+};
+
+int Counted_Link::alive = 0;
+
+struct Fragile_Link : Self_Ptr {
+	Fragile_Link() = default;
+	Fragile_Link(const Fragile_Link&) : Self_Ptr() { throw std::runtime_error("Fragile_Link"); }
+};
+
+// A tree node with a pointer to its parent, which copies remap
+struct Tree_Node {
+	using ptr = poly<Tree_Node, pl::iterative<Tree_Node, true>>;
+
+	ptr left;
+	ptr right;
+	Tree_Node* parent;
+
+	Tree_Node() : parent(nullptr) {}
+	Tree_Node(const Tree_Node& other) :
+		left(other.left),
+		right(other.right),
+		parent(pl::iterative_clone_of(other.parent)) {
+	}
+	virtual ~Tree_Node() = default;
+};
+
+Tree_Node::ptr make_tree(int depth, Tree_Node* parent) {
+	auto rslt = pl::make<Tree_Node::ptr, Tree_Node>();
+	rslt->parent = parent;
+	if (depth > 1) {
+		rslt->left = make_tree(depth - 1, rslt.get());
+		rslt->right = make_tree(depth - 1, rslt.get());
+	}
+	return rslt;
+}
+
+// Counts nodes of a tree, and checks that every child points to its parent
+bool parents_match(const Tree_Node* root, std::size_t& count) {
+	std::vector<const Tree_Node*> stack{root};
+	count = 0;
+	while (!stack.empty()) {
+		const Tree_Node* node = stack.back();
+		stack.pop_back();
+		++count;
+		for (const Tree_Node* child : {node->left.get(), node->right.get()}) {
+			if (!child) continue;
+			if (child->parent != node) return false;
+			stack.push_back(child);
+		}
+	}
+	return true;
+}
+
+// A tree node, that keeps its children in a std::vector, which moves them
+// while it grows during a copy
+struct Vector_Node {
+	using ptr = poly<Vector_Node, pl::iterative<Vector_Node>>;
+
+	std::vector<ptr> children;
+	ptr first; // Made from the copy of the first child
+	int value;
+
+	explicit Vector_Node(int value) : value(value) {}
+	Vector_Node(const Vector_Node& other) : value(other.value) {
+		for (const ptr& child : other.children) children.push_back(child);
+		if (!children.empty()) first = children.front();
+		ptr dropped = other.first;
+	}
+	virtual ~Vector_Node() = default;
+};
+
+Vector_Node::ptr make_vector_tree(int depth, int& next_value) {
+	auto rslt = pl::make<Vector_Node::ptr, Vector_Node>(next_value++);
+	if (depth > 1) {
+		for (int i = 0; i < 8; ++i) rslt->children.push_back(make_vector_tree(depth - 1, next_value));
+		rslt->first = rslt->children.front();
+	}
+	return rslt;
+}
+
+// Sums values of a tree, and checks that every first is a copy of the
+// first child
+bool firsts_match(const Vector_Node* node, long& sum) {
+	sum += node->value;
+	if (node->children.empty()) return !node->first;
+
+	const Vector_Node* first = node->first.get();
+	if (!first || first == node->children.front().get() ||
+		first->value != node->children.front()->value) return false;
+	for (const auto& child : node->children) {
+		if (!firsts_match(child.get(), sum)) return false;
+	}
+	return true;
+}
+
+// A value, kept entirely in the object, for the shared arena
+struct Shared_Value : Base {
+	long value;
+
+	explicit Shared_Value(long value) : value(value) {}
+};
+
+} // namespace
+
 #define TEST(...) print_test_result(#__VA_ARGS__, __VA_ARGS__)
 
 void Tester::print_test_result(const std::string& name, bool result) {
@@ -92,6 +421,203 @@ void Tester::run() {
 		TEST(p0 >= nullptr);
 
 		TEST(std::hash<poly<Base, pl::unique<Base>>>()(p1) == std::hash<Base*>()(p1.get()));
+
+		// The pointer constructor, assignment and reset reject objects from new
+		// for policies, that make their objects themselves
+		TEST(!pl::detail::has_create<pl::deep<Base>>::value);
+		TEST(pl::detail::has_create<pl::aligned<Base>>::value &&
+			pl::detail::has_create<pl::compacting<Base>>::value &&
+			pl::detail::has_create<pl::recycling<Base>>::value &&
+			pl::detail::has_create<pl::shared_memory<Base>>::value);
+		poly<Base> p10;
+		p10.reset(new Mid1);
+		TEST(p10.is<Mid1>() && p10->name() == "mid1");
+	}
+
+	// slim ===================================================================
+	{
+		using slim_poly = poly<Base, pl::slim<Base>>;
+
+		static_assert(sizeof(slim_poly) == sizeof(Base*), "EBO failed");
+
+		slim_poly p1(new Der);
+		slim_poly p2 = pl::make<slim_poly, Mid1>();
+		slim_poly p3(p1);
+		slim_poly p4;
+		p4 = p2;
+		poly<const Base, pl::slim<const Base>> p5(p3);
+		auto p6 = pl::transform<poly<Mid2, pl::slim<Mid2>>, Der>(p3);
+		auto p7 = p6;
+
+		TEST(p3.is<Der>());
+		TEST(p4.is<Mid1>());
+		TEST(p5.is<Der>());
+		TEST(p7.is<Der>());
+
+		TEST(p3.get() != p1.get());
+		TEST(p4.get() != p2.get());
+
+		TEST(p3->name() == "der");
+		TEST(p4->name() == "mid1");
+		TEST(p7->name() == "der");
+
+		// The registry grows in place, values never move
+		pl::detail::snapshot_map<int, int> map;
+		const int* first = &map.insert(0, 100);
+		for (int i = 1; i < 1000; ++i) map.insert(i, 100 + i);
+		bool all_found = true;
+		for (int i = 0; i < 1000; ++i) {
+			const int* value = map.find(i);
+			all_found = all_found && value && *value == 100 + i;
+		}
+		TEST(all_found && map.find(0) == first && map.find(1000) == nullptr);
+		TEST(&map.insert(5, 0) == map.find(5) && *map.find(5) == 105);
+	}
+
+	// dispatch ===============================================================
+	{
+		using types = pl::type_list<Mid1, Mid2, Der>;
+
+		auto p1 = pl::make<poly<Base>, Mid1>();
+		auto p2 = pl::make<poly<Base>, Mid2>();
+		auto p3 = pl::make<poly<Base>, Der>();
+		auto p4 = pl::make<poly<Base>, Base>();
+		poly<const Base> p5(p3);
+
+		TEST(pl::dispatch<types, types>(p1, p1, Collide()) == "mid1-mid1");
+		TEST(pl::dispatch<types, types>(p1, p2, Collide()) == "mid1-mid2");
+		TEST(pl::dispatch<types, types>(p3, p3, Collide()) == "der-der");
+		TEST(pl::dispatch<types, types>(p3, p5, Collide()) == "der-der");
+		TEST(pl::dispatch<types, types>(p2, p1, Collide(), Collide_Fallback()) == "fallback");
+		TEST(pl::dispatch<types, types>(p4, p1, Collide(), Collide_Fallback()) == "fallback");
+		TEST(pl::symmetric_dispatch<types>(p2, p1, Collide()) == "mid1-mid2");
+
+		bool thrown = false;
+		try {
+			pl::dispatch<types, types>(p2, p1, Collide());
+		}
+		catch (std::invalid_argument&) {
+			thrown = true;
+		}
+		TEST(thrown);
+	}
+
+	// parallel algorithms ====================================================
+	{
+		std::vector<poly<Base>> v;
+		for (int i = 0; i < 1000; ++i) {
+			switch (i % 4) {
+			case 0: v.push_back(pl::make<poly<Base>, Der>()); break;
+			case 1: v.push_back(pl::make<poly<Base>, Mid1>()); break;
+			case 2: v.push_back(pl::make<poly<Base>, Mid2>()); break;
+			case 3: v.push_back(poly<Base>()); break;
+			}
+		}
+
+		pl::thread_pool pool(4);
+		using types = pl::type_list<Mid1>;
+
+		std::atomic<int> mid1(0);
+		std::atomic<int> other(0);
+		pl::par::for_each<types>(v, Count_Names{&mid1, &other}, pool);
+		TEST(mid1 == 250 && other == 500);
+
+		std::atomic<int> all(0);
+		pl::par::for_each(v, [&all](Base&) { ++all; });
+		TEST(all == 750);
+
+		auto total = pl::par::transform_reduce(v, std::size_t(0),
+			std::plus<std::size_t>(), Name_Length(), pool);
+		TEST(total == 250 * 3 + 500 * 4);
+
+		auto v2 = v;
+		auto it1 = pl::par::partition<types>(v, Is_Mid1(), pool);
+		auto it2 = pl::par::stable_partition<types>(v2, Is_Mid1(), pool);
+		TEST(it1 - v.begin() == 250 && it2 - v2.begin() == 250);
+		TEST(std::all_of(v.begin(), it1, [](const poly<Base>& p) { return p.is<Mid1>(); }));
+		TEST(std::none_of(it1, v.end(), [](const poly<Base>& p) { return p.is<Mid1>(); }));
+		TEST(std::all_of(v2.begin(), it2, [](const poly<Base>& p) { return p.is<Mid1>(); }));
+		TEST(it2[0].is<Der>() && it2[1].is<Mid2>() && !it2[2] && it2[3].is<Der>());
+	}
+
+	// deferred delete ========================================================
+	{
+		using deferred_poly = poly<Base,
+			pl::compound<pl::deep_copy<Base>, pl::deferred_delete<Base>>>;
+
+		std::vector<deferred_poly> v;
+		for (int i = 0; i < 10; ++i) {
+			v.push_back(pl::make<deferred_poly, Counted>());
+		}
+		poly<const Base, pl::compound<pl::deep_copy<const Base>,
+			pl::deferred_delete<const Base>>> p1(v[0]);
+		TEST(Counted::alive == 11);
+
+		v.clear();
+		p1.reset();
+		TEST(Counted::alive == 11);
+		TEST(pl::drain() == 11);
+		TEST(Counted::alive == 0);
+
+		pl::reclaimer r(2);
+		r.retire(new Counted, &pl::detail::delete_erased<Base>);
+		r.retire(new Counted, &pl::detail::delete_erased<Base>);
+		r.retire(new Counted, &pl::detail::delete_erased<Base>);
+		TEST(r.overflows() == 1 && Counted::alive == 2);
+
+		r.start();
+		for (int i = 0; i < 1000 && Counted::alive != 0; ++i) {
+			std::this_thread::sleep_for(std::chrono::milliseconds(1));
+		}
+		TEST(Counted::alive == 0);
+		r.stop();
+	}
+
+	// atomic_poly ============================================================
+	{
+		pl::atomic_poly<Base> a(pl::make<poly<Base>, Mid1>());
+		{
+			auto h1 = a.load();
+			a.store(pl::make<poly<Base>, Counted>());
+			auto h2 = a.load();
+
+			TEST(h1->name() == "mid1");
+			TEST(h2->name() == "base");
+
+			auto desired = pl::make<poly<Base>, Mid2>();
+			TEST(!a.compare_exchange(h1, desired));
+			TEST(static_cast<bool>(desired));
+			TEST(a.compare_exchange(h2, desired));
+			TEST(!desired);
+			TEST(Counted::alive == 1);
+		}
+
+		pl::detail::epoch_domain::instance().collect();
+		pl::detail::epoch_domain::instance().collect();
+		TEST(Counted::alive == 0);
+
+		auto old = a.exchange(pl::make<poly<Base>, Der>());
+		TEST(old.is<Mid2>());
+		TEST(a.load()->name() == "der");
+
+		// Readers and a writer at the same time
+		std::atomic<bool> stop(false);
+		std::atomic<int> errors(0);
+		std::vector<std::thread> readers;
+		for (int i = 0; i < 4; ++i) {
+			readers.emplace_back([&] {
+				while (!stop) {
+					auto h = a.load();
+					if (h->name() != "der" && h->name() != "mid1") ++errors;
+				}
+			});
+		}
+		for (int i = 0; i < 1000; ++i) {
+			a.store(i % 2 ? pl::make<poly<Base>, Der>() : pl::make<poly<Base>, Mid1>());
+		}
+		stop = true;
+		for (auto& t : readers) t.join();
+		TEST(errors == 0);
 	}
 
 	// factory ============================================================
@@ -120,7 +646,988 @@ void Tester::run() {
 		TEST(!p1.is<Base>());
 		TEST(!p2.is<Base>());
 		TEST(!p3.is<Base>());
+
+		TEST(f.contains(typeid(Der).name()));
+		TEST(!f.contains(typeid(Mid3).name()));
+	}
+
+	// factory handles ========================================================
+	{
+		pl::factory<Base> f;
+		auto h1 = f.insert<Mid2>();
+		auto h2 = f.insert<Der>();
+		auto h3 = f.insert<Mid1>();
+		auto h4 = f.insert<Base>();
+
+		TEST(h1 == 0 && h2 == 1 && h3 == 2 && h4 == 3);
+		TEST(f.insert<Der>() == h2);
+		TEST(f.id_of(typeid(Mid1).name()) == h3);
+
+		std::vector<std::string> names{
+			typeid(Der).name(), typeid(Der).name(), typeid(Base).name(), typeid(Mid2).name()};
+		std::vector<pl::factory<Base>::handle> ids;
+		f.id_of(names.begin(), names.end(), std::back_inserter(ids));
+		TEST(ids == std::vector<pl::factory<Base>::handle>({h2, h2, h4, h1}));
+
+		TEST(f.make(h1).is<Mid2>());
+		TEST(f.make(h2).is<Der>());
+		TEST(f.make(h4).is<Base>());
+
+		bool thrown = false;
+		try {
+			f.make(pl::factory<Base>::handle(4));
+		}
+		catch (std::out_of_range&) {
+			thrown = true;
+		}
+		TEST(thrown);
+	}
+
+	// factory prototypes =====================================================
+	{
+		pl::factory<Base> f;
+		f.insert<Mid1>();
+
+		auto warm = pl::make<poly<Base>, Mid1>();
+		warm.as<Mid1>()->mid1_name = "warm mid1";
+		f.insert_prototype("warm", warm);
+		f.insert_prototype(typeid(Mid1).name(), warm);
+		f.insert_prototype<Mid2>();
+
+		auto p1 = f.make("warm");
+		auto p2 = f.make("warm");
+		auto p3 = f.make(typeid(Mid1).name());
+		auto p4 = f.make(typeid(Mid2).name());
+
+		TEST(p1->name() == "warm mid1" && p3->name() == "warm mid1");
+		TEST(p1.is<Mid1>() && p4.is<Mid2>());
+		TEST(p1.get() != p2.get() && p1.get() != warm.get());
+		TEST(f.type_of("warm") != nullptr && *f.type_of("warm") == typeid(Mid1));
+		TEST(pl::lazy_poly<Base>(f, "warm").is<Mid1>());
+	}
+
+	// lazy_poly ==============================================================
+	{
+		pl::factory<Base> f;
+		f.insert<Counted>();
+		f.insert<Mid1>();
+
+		pl::lazy_poly<Base> p1(f, typeid(Counted).name());
+		pl::lazy_poly<Base> p2(f, typeid(Mid1).name());
+		pl::lazy_poly<Base> p3(f, typeid(Mid2).name());
+		pl::lazy_poly<Base> p4;
+
+		TEST(p1.is<Counted>() && !p1.is<Mid1>());
+		TEST(!p3.is<Mid2>());
+		TEST(!p1.constructed() && Counted::alive == 0);
+
+		std::vector<std::thread> threads;
+		std::atomic<int> same(0);
+		for (int i = 0; i < 4; ++i) {
+			threads.emplace_back([&] { if (p1.get() == p1.get()) ++same; });
+		}
+		for (auto& t : threads) t.join();
+		TEST(same == 4 && Counted::alive == 1);
+
+		auto p5 = p1;
+		auto p6 = p2;
+		TEST(p5.constructed() && Counted::alive == 2);
+		TEST(!p6.constructed());
+		TEST(p6->name() == "mid1");
+		TEST(p6.as<Mid1>() != nullptr);
+		TEST(p4.get() == nullptr);
+
+		bool thrown = false;
+		try {
+			p3.get();
+		}
+		catch (std::invalid_argument&) {
+			thrown = true;
+		}
+		TEST(thrown);
+	}
+
+	// parallel make and destroy ==============================================
+	{
+		pl::factory<Base> f;
+		f.insert<Der>();
+		f.insert<Mid1>();
+
+		std::vector<std::string> names;
+		for (int i = 0; i < 1000; ++i) {
+			names.push_back(i % 2 ? typeid(Mid1).name() : typeid(Der).name());
+		}
+
+		pl::thread_pool pool(4);
+		std::vector<poly<Base>> v1(names.size());
+		std::vector<poly<Base>> v2(names.size());
+		auto end1 = pl::parallel_make(f, names, v1.begin(), pool);
+		Inline_Executor inline_executor;
+		pl::parallel_make(f, names, v2.begin(), inline_executor);
+
+		TEST(end1 == v1.end());
+		TEST(v1[0].is<Der>() && v1[1].is<Mid1>() && v1[999].is<Mid1>());
+		TEST(v2[0].is<Der>() && v2[1].is<Mid1>() && v2[999].is<Mid1>());
+
+		pl::parallel_destroy(v1, pool);
+		pl::parallel_destroy(v2);
+		TEST(std::all_of(v1.begin(), v1.end(), [](const poly<Base>& p) { return !p; }));
+		TEST(std::all_of(v2.begin(), v2.end(), [](const poly<Base>& p) { return !p; }));
+
+		names[500] = "not a type";
+		bool thrown = false;
+		try {
+			pl::parallel_make(f, names, v1.begin(), pool);
+		}
+		catch (std::invalid_argument&) {
+			thrown = true;
+		}
+		TEST(thrown);
+
+		// Tasks, pushed from several threads, are all run, before the pool
+		// is destroyed
+		std::atomic<int> ran(0);
+		{
+			pl::thread_pool small_pool(2);
+			std::vector<std::thread> producers;
+			for (int t = 0; t < 4; ++t) {
+				producers.emplace_back([&small_pool, &ran] {
+					for (int i = 0; i < 2500; ++i) small_pool.execute([&ran] { ++ran; });
+				});
+			}
+			for (auto& t : producers) t.join();
+		}
+		TEST(ran == 10000);
+
+		// If the executor fails, chunks, that it took, finish first
+		std::vector<poly<Base>> v3;
+		for (int i = 0; i < 1000; ++i) v3.push_back(pl::make<poly<Base>, Counted>());
+		int alive = Counted::alive;
+		thrown = false;
+		{
+			Limited_Executor limited(3);
+			try {
+				pl::parallel_destroy(v3, limited);
+			}
+			catch (std::runtime_error&) {
+				thrown = true;
+				TEST(!v3[374] && v3[375] && Counted::alive == alive - 375);
+			}
+		}
+		TEST(thrown);
+	}
+	// casts to any base =====================================================
+	{
+		poly<Mid1> p1 = pl::make<poly<Mid1>, Der>();
+		const poly<const Mid1, pl::unique<const Mid1>> p2 =
+			pl::make<poly<const Mid1, pl::unique<const Mid1>>, Der>();
+		poly<Mid1> p3 = pl::make<poly<Mid1>, Mid1>();
+
+		TEST(p1.as_base<Mid2>() == static_cast<Mid2*>(p1.as<Der>()));
+		TEST(p1.as_base<Mid2>()->name() == "der");
+		TEST(p1.as_base<Base>() == static_cast<Base*>(p1.get()));
+		TEST(p1.as_base<Mid3>() == nullptr);
+		TEST(p2.as_base<const Mid2>() != nullptr);
+		TEST(p3.as_base<Mid2>() == nullptr);
+		TEST(poly<Mid1>().as_base<Mid2>() == nullptr);
+
+		Der* der = p1.as<Der>();
+		auto p4 = pl::cast<poly<Mid2, pl::unique<Mid2>>>(std::move(p1));
+		TEST(!p1 && p4.get() == static_cast<Mid2*>(der));
+		TEST(p4.is<Der>() && p4.as<Der>() == der);
+
+		auto p5 = pl::cast<poly<Mid2, pl::unique<Mid2>>>(std::move(p3));
+		TEST(!p5 && p3);
+
+		// The object's type, registered for Mid1, is found for Mid2
+		auto p6 = pl::make<poly<Mid1, pl::slim<Mid1>>, Der>();
+		p6.as<Der>()->der_name = "cast der";
+		auto p7 = pl::cast<poly<Mid2, pl::slim<Mid2>>>(std::move(p6));
+		auto p8 = p7;
+		TEST(!p6 && p7.is<Der>() && p8.is<Der>() && p8.get() != p7.get());
+		TEST(p8->name() == "cast der");
+
+		// Only policies with the same deleter can take over each other's objects
+		TEST(pl::detail::same_deleter<pl::deep<Mid1>, pl::slim<const Mid2>>::value);
+		TEST(!pl::detail::same_deleter<pl::unique<Mid1>, pl::in_place<Mid1>>::value);
+		TEST(!pl::detail::same_deleter<pl::deep<Mid1>, pl::iterative<Mid1>>::value);
+	}
+	// any_of ================================================================
+	{
+		Shape s1 = Square{2};
+		Shape s2 = Large_Square();
+		s2.as<Large_Square>()->side = 3;
+		Shape s3;
+
+		TEST(s1.call<Area>() == 4);
+		TEST(s2.call<Area>() == 9);
+		TEST(s1.is<Square>() && !s1.is<Large_Square>() && s1.type() == typeid(Square));
+		TEST(!s3 && s3.type() == typeid(void) && s3.as<Square>() == nullptr);
+		TEST(Shape::is_local<Square>::value && !Shape::is_local<Large_Square>::value);
+		TEST(!s1.is<int>() && s1.as<std::string>() == nullptr);
+
+		s1.call<Scale>(1.5);
+		const Shape& cs1 = s1;
+		TEST(cs1.call<Area>() == 9);
+
+		s3 = s1;
+		s3.call<Scale>(2);
+		TEST(s1.call<Area>() == 9 && s3.call<Area>() == 36);
+
+		const Large_Square* large = s2.as<Large_Square>();
+		Shape s4 = std::move(s2);
+		TEST(!s2 && s4.as<Large_Square>() == large);
+
+		s4.emplace<Square>(Square{1});
+		TEST(s4.call<Area>() == 1);
+
+		pl::any_of<pl::type_list<Area, Scale>, pl::heap_storage> s5 = Square{5};
+		TEST(s5.call<Area>() == 25);
+
+		Shape s6 = Polygon{{1, 2, 3}, nullptr};
+		TEST(s6.call<Area>() == 3);
+		bool thrown = false;
+		try {
+			Shape s7 = s6;
+		}
+		catch (std::runtime_error&) {
+			thrown = true;
+		}
+		TEST(thrown);
+	}
+	// bound methods =========================================================
+	{
+		using Types = pl::type_list<Der, Mid1, Mid2>;
+		poly<Base> p1 = pl::make<poly<Base>, Der>();
+		poly<const Base> p2 = pl::make<poly<Base>, Mid2>();
+		poly<Base> p3 = pl::make<poly<Base>, Mid3>();
+
+		pl::bound_method<Exact_Name> name1 = pl::bound<Exact_Name, Types>(p1);
+		TEST(name1 && name1() == "der");
+
+		p1.as<Der>()->der_name = "changed";
+		TEST(name1() == "changed");
+
+		auto suffix = pl::bound<Name_Suffix, Types>(p2);
+		TEST(suffix("!") == std::string(typeid(Mid2).name()) + "!");
+		TEST(!pl::bound_method<Exact_Name>());
+
+		bool thrown_type = false;
+		try {
+			pl::bound<Exact_Name, Types>(p3);
+		}
+		catch (std::invalid_argument&) {
+			thrown_type = true;
+		}
+		TEST(thrown_type);
+
+		bool thrown_empty = false;
+		try {
+			pl::bound<Exact_Name, Types>(poly<Base>());
+		}
+		catch (std::invalid_argument&) {
+			thrown_empty = true;
+		}
+		TEST(thrown_empty);
+	}
+	// relocation ============================================================
+	{
+		TEST(pl::is_trivially_relocatable<poly<Base>>::value);
+		TEST(pl::is_trivially_relocatable<poly<const Base, pl::unique<const Base>>>::value);
+		TEST(pl::is_trivially_relocatable<poly<Base, pl::slim<Base>>>::value);
+		TEST(!pl::is_trivially_relocatable<std::unique_ptr<int>>::value);
+
+		{
+			pl::vector<poly<Base>> v;
+			for (int i = 0; i < 100; ++i) v.push_back(pl::make<poly<Base>, Counted>());
+			v.emplace_back(pl::make<poly<Base>, Der>());
+			TEST(v.size() == 101 && v.capacity() >= 101 && Counted::alive == 100);
+			TEST(v.back().is<Der>() && v.front().is<Counted>());
+
+			auto it = v.insert(v.begin() + 50, pl::make<poly<Base>, Mid1>());
+			TEST(it == v.begin() + 50 && v[50].is<Mid1>() && v[51].is<Counted>());
+			TEST(v.size() == 102 && v.back().is<Der>());
+
+			v.insert(v.begin() + 1, v[50]);
+			TEST(v[1].is<Mid1>() && v[51].is<Mid1>() && v[1] != v[51]);
+
+			it = v.erase(v.begin() + 2, v.begin() + 12);
+			TEST(it == v.begin() + 2 && v.size() == 93 && Counted::alive == 90);
+
+			pl::vector<poly<Base>> copy = v;
+			TEST(copy.size() == 93 && Counted::alive == 180 && copy[0] != v[0]);
+
+			pl::vector<poly<Base>> moved = std::move(copy);
+			TEST(moved.size() == 93 && copy.empty() && Counted::alive == 180);
+
+			v.erase(v.begin());
+			v.pop_back();
+			TEST(v.size() == 91 && v[0].is<Mid1>() && Counted::alive == 179);
+		}
+		TEST(Counted::alive == 0);
+
+		pl::vector<std::string> strings{"a", "b", "c"};
+		strings.insert(strings.begin() + 1, "x");
+		strings.insert(strings.begin(), strings[3]);
+		strings.erase(strings.begin() + 2);
+		TEST(strings.size() == 4 &&
+			strings[0] == "c" && strings[1] == "a" && strings[2] == "b" && strings[3] == "c");
+	}
+	// intern_pool ===========================================================
+	{
+		using Pool = pl::intern_pool<Base, Label_Hash, Label_Equal>;
+		Pool::handle outliving;
+		{
+			Pool pool(4);
+			auto h1 = pool.intern(pl::make<poly<Base>, Label>("a"));
+			auto h2 = pool.intern(pl::make<poly<Base>, Label>("a"));
+			auto h3 = pool.intern(pl::make<poly<Base>, Label>("b"));
+			auto h4 = pool.intern(pl::make<poly<Base>, Mid1>());
+			auto h5 = pool.intern(pl::make<poly<Base>, Mid1>());
+			TEST(h1 == h2 && h1 != h3 && h4 == h5 && pool.size() == 3);
+			TEST(static_cast<const Label&>(*h1).text == "a");
+			TEST(!pool.intern(Pool::poly_type()));
+
+			h1.reset();
+			TEST(pool.size() == 3);
+			h2.reset();
+			TEST(pool.size() == 2);
+			auto h6 = pool.intern(pl::make<poly<Base>, Label>("a"));
+			TEST(pool.size() == 3);
+
+			vector<thread> threads;
+			vector<vector<Pool::handle>> held(4);
+			for (size_t t = 0; t < 4; ++t) {
+				threads.emplace_back([&pool, &held, t] {
+					for (int i = 0; i < 1000; ++i) {
+						held[t].push_back(pool.intern(
+							pl::make<poly<Base>, Label>(std::to_string(i % 10))));
+					}
+				});
+			}
+			for (auto& t : threads) t.join();
+			TEST(pool.size() == 13);
+			TEST(held[0][3] == held[3][3] && held[1][13] == held[2][3]);
+
+			outliving = h3;
+		}
+		TEST(static_cast<const Label&>(*outliving).text == "b");
+	}
+	// inline_cache ==========================================================
+	{
+		pl::inline_cache<Base, 2, pl::type_list<Der, Mid1>> cache;
+		auto der = pl::make<poly<Base>, Der>();
+		auto mid1 = pl::make<poly<Base>, Mid1>();
+		auto mid2 = pl::make<poly<Base>, Mid2>();
+		auto mid3 = pl::make<poly<Base>, Mid3>();
+
+		TEST(cache(der, Which_Overload()) == "der");
+		TEST(cache(mid1, Which_Overload()) == "mid1");
+		TEST(cache(mid2, Which_Overload()) == "virtual mid2");
+		TEST(cache.hits() == 0 && cache.misses() == 3);
+
+		Which_Overload handler;
+		for (int i = 0; i < 10; ++i) cache(der, handler);
+		TEST(cache(der, handler) == "der" && cache.hits() == 11);
+
+		// mid3 becomes common and replaces a cached type
+		for (int i = 0; i < 100; ++i) cache(mid3, handler);
+		size_t hits = cache.hits();
+		TEST(cache(mid3, handler) == "virtual mid3" && cache.hits() == hits + 1);
+		TEST(cache.hit_rate() > 0.5 && cache.hit_rate() < 1);
+
+		cache.reset_counters();
+		TEST(cache.hits() == 0 && cache.misses() == 0 && cache.hit_rate() == 0);
+
+		bool thrown = false;
+		try {
+			cache(poly<Base>(), handler);
+		}
+		catch (std::invalid_argument&) {
+			thrown = true;
+		}
+		TEST(thrown);
+	}
+	// aligned policy ========================================================
+	{
+		using Aligned = poly<Base, pl::aligned<Base>>;
+		Aligned p1 = pl::make<Aligned, Der>();
+		Aligned p2 = p1;
+		TEST(is_aligned(p1, 64) && is_aligned(p2, 64) && p2.is<Der>() && p1 != p2);
+
+		using Page = poly<Base, pl::aligned<Base, 4096>>;
+		Page p3 = pl::make<Page, Mid1>();
+		TEST(is_aligned(p3, 4096) && p3->name() == "mid1");
+
+		Aligned p4 = pl::make<Aligned, Over_Aligned>();
+		TEST(is_aligned(p4, 128) && is_aligned(Aligned(p4), 128));
+
+		Aligned p5 = pl::transform<Aligned, Mid1>(pl::make<poly<Base>, Mid1>());
+		pl::factory<Base, pl::aligned<Base>> f;
+		f.insert<Mid2>();
+		TEST(is_aligned(p5, 64) && is_aligned(f.make(typeid(Mid2).name()), 64));
+
+		{
+			vector<Aligned> counted;
+			for (int i = 0; i < 10; ++i) counted.push_back(pl::make<Aligned, Counted>());
+			counted.push_back(counted[0]);
+			TEST(Counted::alive == 11);
+		}
+		TEST(Counted::alive == 0);
+	}
+	// factory layouts =======================================================
+	{
+		pl::factory<Base> f;
+		f.insert<Mid1>();
+		f.insert<Der>();
+		f.insert<Counted>();
+		f.insert_prototype<Label>("proto");
+		f.insert_prototype("Mid2 prototype", pl::make<poly<Base>, Mid2>());
+		const string mid1 = typeid(Mid1).name();
+		const string label = typeid(Label).name();
+
+		TEST(f.size_of(mid1) == sizeof(Mid1) && f.align_of(mid1) == alignof(Mid1));
+		TEST(f.max_size() == std::max({sizeof(Mid1), sizeof(Der), sizeof(Counted), sizeof(Label)}));
+		TEST(f.max_align() >= alignof(Der));
+		TEST(f.layout_of("Mid2 prototype") == nullptr && f.layout_of("not a type") == nullptr);
+
+		alignas(std::max_align_t) unsigned char buffer1[256];
+		alignas(std::max_align_t) unsigned char buffer2[256];
+		{
+			auto p1 = f.construct_at(mid1, buffer1);
+			TEST(p1.is<Mid1>() && p1->name() == "mid1" &&
+				dynamic_cast<void*>(p1.get()) == static_cast<void*>(buffer1));
+
+			auto p2 = f.construct_at(label, buffer2);
+			TEST(p2.is<Label>() && p2.as<Label>()->text == "proto");
+
+			auto p3 = f.construct_at(typeid(Counted).name(), buffer1 + 128);
+			TEST(Counted::alive == 1);
+		}
+		TEST(Counted::alive == 0);
+
+		{
+			auto p1 = f.construct_at(label, buffer1);
+			auto p2 = f.layout_of(label)->move(buffer2, *p1);
+			TEST(p2.as<Label>()->text == "proto" && p1.as<Label>()->text.empty());
+		}
+
+		{
+			// An object, released from its poly, is destroyed through the layout
+			Base* counted = f.construct_at(typeid(Counted).name(), buffer1).release();
+			TEST(Counted::alive == 1);
+			f.layout_of(typeid(Counted).name())->destroy(counted);
+			TEST(Counted::alive == 0);
+		}
+
+		bool thrown_size = false;
+		try {
+			f.size_of("Mid2 prototype");
+		}
+		catch (std::invalid_argument&) {
+			thrown_size = true;
+		}
+		bool thrown_construct = false;
+		try {
+			f.construct_at("Mid2 prototype", buffer1);
+		}
+		catch (std::invalid_argument&) {
+			thrown_construct = true;
+		}
+		TEST(thrown_size && thrown_construct);
+	}
+	// tagged_vector =========================================================
+	{
+		// 100 elements, so that both the vector and the scalar parts of the
+		// scans are used
+		pl::tagged_vector<Base> v;
+		std::vector<std::size_t> expected_der;
+		for (std::size_t i = 0; i < 100; ++i) {
+			if (i % 7 == 0) v.push_back(nullptr);
+			else if (i % 3 == 0) {
+				v.emplace_back<Der>();
+				expected_der.push_back(i);
+			}
+			else v.emplace_back<Mid1>();
+		}
+
+		std::size_t mid1_count = 0;
+		for (auto& p : v) if (p.is<Mid1>()) ++mid1_count;
+
+		TEST(v.size() == 100 && v.count<Mid1>() == mid1_count);
+		TEST(v.count<Der>() == expected_der.size() && v.count<Mid2>() == 0);
+		TEST(v.tag_of<Mid2>() == v.no_tag && v.tag(0) == v.empty_tag);
+		TEST(v.type_of(v.tag_of<Der>()) == &typeid(Der) && v.type_of(v.empty_tag) == nullptr);
+
+		std::vector<std::size_t> found_der;
+		v.find_all<Der>(std::back_inserter(found_der));
+		TEST(found_der == expected_der);
+
+		v.set(0, pl::make<poly<Base>, Mid2>());
+		v.erase(1);
+		TEST(v.count<Mid2>() == 1 && v[0].is<Mid2>() && v.size() == 99);
+
+		std::size_t n = v.partition<Der>();
+		bool partitioned = n == expected_der.size();
+		for (std::size_t i = 0; i < v.size(); ++i) {
+			partitioned = partitioned && (i < n) == v[i].is<Der>() &&
+				v.type_of(v.tag(i)) == (v[i] ? &typeid(*v[i]) : nullptr);
+		}
+		TEST(partitioned && v[n].is<Mid2>());
+
+		v.clear();
+		TEST(v.empty() && v.tag_of<Der>() == v.no_tag);
+
+		// Longer than 255 vector steps, so that the counters are flushed
+		std::vector<std::uint8_t> tags(32 * 300 + 5);
+		for (std::size_t i = 0; i < tags.size(); ++i) tags[i] = i % 2 == 0 ? 1 : 2;
+		TEST(pl::detail::tag_count(tags.data(), tags.size(), 1) == 32 * 150 + 3);
+	}
+	// poly_slot_map =========================================================
+	{
+		pl::poly_slot_map<Base> m;
+		auto h1 = m.emplace<Mid1>();
+		auto h2 = m.emplace<Der>();
+		auto h3 = m.insert(pl::make<poly<Base>, Mid2>());
+
+		TEST(m.size() == 3 && m.contains(h2) && !m.contains(m.null_handle));
+		TEST(m.get<Der>(h2) != nullptr && m.get<Mid1>(h2) == nullptr);
+		TEST(m.at(h3)->name() == "mid2" && m.find(h1)->is<Mid1>());
+
+		// Erasing moves the last poly, but its handle stays valid
+		TEST(m.erase(h1) && !m.erase(h1) && m.size() == 2);
+		TEST(!m.contains(h1) && m.find(h1) == nullptr && m.get<Mid1>(h1) == nullptr);
+		TEST(m.at(h3).is<Mid2>() && m.at(h2).is<Der>());
+
+		// The slot of h1 is reused with a new generation
+		auto h4 = m.emplace<Mid1>();
+		TEST(h4 != h1 && static_cast<std::uint32_t>(h4) == static_cast<std::uint32_t>(h1));
+		TEST(!m.contains(h1) && m.at(h4).is<Mid1>());
+
+		bool handles_match = true;
+		for (std::size_t i = 0; i < m.size(); ++i) {
+			handles_match = handles_match && m.find(m.handle_of(i)) == m.begin() + i;
+		}
+		TEST(handles_match && m.end() - m.begin() == 3);
+
+		bool thrown = false;
+		try {
+			m.at(h1);
+		}
+		catch (std::out_of_range&) {
+			thrown = true;
+		}
+		TEST(thrown);
+
+		m.clear();
+		TEST(m.empty() && !m.contains(h2) && !m.contains(h4));
+		auto h5 = m.emplace<Der>();
+		TEST(m.size() == 1 && m.contains(h5) && !m.contains(h2));
+	}
+	// poly_queue ============================================================
+	{
+		using Message = poly<Base, pl::unique<Base>>;
+
+		pl::poly_queue<Base, pl::unique<Base>, pl::spsc> q1(3);
+		pl::poly_queue<Base> q2(4);
+		TEST(q1.capacity() == 4 && q2.capacity() == 4);
+
+		// Pushing keeps the object, popping returns it in FIFO order
+		Message m = pl::make<Message, Mid1>();
+		Base* obj = m.get();
+		TEST(q1.try_push(m) && !m && q1.pop().get() == obj);
+
+		std::vector<Message> in;
+		for (int i = 0; i < 6; ++i) in.push_back(pl::make<Message, Sequenced>(0, i));
+		auto spsc_end = q1.try_push(in.begin(), in.end());
+		auto mpmc_end = q2.try_push(in.begin() + 4, in.end());
+		TEST(spsc_end == in.begin() + 4 && mpmc_end == in.end() && in[4] == nullptr);
+
+		Message full = pl::make<Message, Mid2>();
+		TEST(!q1.try_push(full) && full != nullptr);
+
+		std::vector<Message> out;
+		TEST(q1.try_pop(std::back_inserter(out), 3) == 3 &&
+			q2.try_pop(std::back_inserter(out), 10) == 2);
+		TEST(q1.try_pop(m) && !q1.try_pop(m) && !q2.try_pop(m));
+		out.push_back(std::move(m));
+
+		bool in_order = out.size() == 6;
+		for (std::size_t i = 0; in_order && i < 3; ++i) {
+			in_order = out[i].as<Sequenced>()->number == static_cast<int>(i);
+		}
+		TEST(in_order && out[3].as<Sequenced>()->number == 4 &&
+			out[5].as<Sequenced>()->number == 3);
+
+		// If out throws, messages that were not moved out stay in the queue
+		auto keeps_unpopped = [](pl::poly_queue<Base, pl::unique<Base>, pl::spsc>* spsc_queue,
+			pl::poly_queue<Base>* mpmc_queue) {
+			std::vector<Message> in, out;
+			for (int i = 0; i < 4; ++i) in.push_back(pl::make<Message, Sequenced>(0, i));
+			if (spsc_queue) spsc_queue->push(in.begin(), in.end());
+			else mpmc_queue->push(in.begin(), in.end());
+
+			bool threw = false;
+			try {
+				Throwing_Output<Message> limited{&out, 2};
+				if (spsc_queue) spsc_queue->try_pop(limited, 4);
+				else mpmc_queue->try_pop(limited, 4);
+			}
+			catch (const std::runtime_error&) {
+				threw = true;
+			}
+
+			std::size_t rest = spsc_queue ? spsc_queue->try_pop(std::back_inserter(out), 4) :
+				mpmc_queue->try_pop(std::back_inserter(out), 4);
+			bool in_order = threw && rest == 2 && out.size() == 4;
+			for (std::size_t i = 0; in_order && i < 4; ++i) {
+				in_order = out[i].as<Sequenced>()->number == static_cast<int>(i);
+			}
+			return in_order;
+		};
+		TEST(keeps_unpopped(&q1, nullptr));
+		TEST(keeps_unpopped(nullptr, &q2));
+
+		// Every message from every producer is received once, and messages
+		// of one producer are received in order
+		auto transfer = [](std::size_t producers, std::size_t consumers, bool use_spsc) {
+			const int n = 20000;
+			pl::poly_queue<Base, pl::unique<Base>, pl::spsc> spsc_queue(64);
+			pl::poly_queue<Base> mpmc_queue(64);
+			std::atomic<int> received(0);
+			std::atomic<bool> ordered(true);
+
+			std::vector<std::thread> threads;
+			for (std::size_t p = 0; p < producers; ++p) {
+				threads.emplace_back([&, p] {
+					for (int i = 0; i < n; ++i) {
+						auto msg = pl::make<Message, Sequenced>(static_cast<int>(p), i);
+						if (use_spsc) spsc_queue.push(std::move(msg));
+						else mpmc_queue.push(std::move(msg));
+					}
+				});
+			}
+			for (std::size_t c = 0; c < consumers; ++c) {
+				threads.emplace_back([&] {
+					std::vector<int> last(producers, -1);
+					while (received < static_cast<int>(producers) * n) {
+						Message msg;
+						if (!(use_spsc ? spsc_queue.try_pop(msg) : mpmc_queue.try_pop(msg))) {
+							std::this_thread::yield();
+							continue;
+						}
+						auto s = msg.as<Sequenced>();
+						if (s->number <= last[s->producer]) ordered = false;
+						last[s->producer] = s->number;
+						++received;
+					}
+				});
+			}
+			for (auto& t : threads) t.join();
+
+			return ordered && received == static_cast<int>(producers) * n;
+		};
+
+		TEST(transfer(1, 1, true));
+		TEST(transfer(2, 2, false));
+	}
+	// compacting arena ======================================================
+	{
+		using Compact = poly<Base, pl::compacting<Base>>;
+		auto& arena = pl::default_arena<Base>();
+
+		// Objects have virtual bases, so Base is not at the start of them
+		std::vector<Compact> v;
+		for (int i = 0; i < 10000; ++i) {
+			if (i % 2 == 0) v.push_back(pl::make<Compact, Der>());
+			else v.push_back(pl::make<Compact, Mid1>());
+		}
+		std::size_t full_blocks = arena.block_count();
+
+		// Keep every 5th object, so that all blocks are mostly empty
+		std::vector<Compact> kept;
+		for (std::size_t i = 0; i < v.size(); i += 5) kept.push_back(std::move(v[i]));
+		v.clear();
+
+		Compact copy = kept[1];
+		Mid1* pinned_object = kept[3].as<Mid1>();
+		Base* pinned = kept[3].release();
+		Base* before = kept[0].get();
+		std::size_t live = arena.live();
+
+		TEST(!arena.compact(std::chrono::nanoseconds(0)));
+		TEST(arena.compact());
+		TEST(arena.block_count() < full_blocks && arena.live() == live);
+		TEST(kept[0].get() != before && kept[0]->name() == "der" && kept[1]->name() == "mid1");
+		TEST(copy->name() == "mid1" && copy.get() != kept[1].get());
+
+		// A released object is not moved
+		TEST(pinned_object->name() == "mid1" && pinned_object == dynamic_cast<Mid1*>(pinned));
+		kept[3] = pl::detail::from_created<Compact>(pinned_object);
+
+		bool all_valid = true;
+		for (std::size_t i = 0; i < kept.size(); ++i) {
+			all_valid = all_valid && kept[i]->name() == (i % 2 == 0 ? "der" : "mid1") &&
+				kept[i]->base_name == "base";
+		}
+		TEST(all_valid);
+
+		// A poly inside a moved object is updated, when its own object moves
+		std::vector<Compact> holders;
+		for (int i = 0; i < 4000; ++i) {
+			holders.push_back(pl::make<Compact, Holder>(pl::make<Compact, Mid2>()));
+		}
+		for (std::size_t i = 0; i < holders.size(); i += 2) holders[i].reset();
+		TEST(arena.compact());
+
+		bool children_valid = true;
+		for (std::size_t i = 1; i < holders.size(); i += 2) {
+			children_valid = children_valid &&
+				holders[i].as<Holder>()->child->name() == "mid2";
+		}
+		TEST(children_valid);
+		holders.clear();
+
+		Compact counted = pl::make<Compact, Counted>();
+		kept.clear();
+		copy.reset();
+		TEST(Counted::alive == 1 && arena.live() > 0);
+		counted.reset();
+		TEST(Counted::alive == 0 && arena.live() == 0);
+	}
+	// factory bulk insertion ================================================
+	{
+		using Factory = pl::factory<Base>;
+		auto warm = pl::make<poly<Base>, Mid1>();
+		warm.as<Mid1>()->mid1_name = "warm mid1";
+
+		// Names repeat within the batch, and with types inserted before
+		std::vector<Factory::registration> batch;
+		batch.push_back(Factory::registration::of<Der>());
+		batch.push_back(Factory::registration::of<Mid1>());
+		batch.push_back(Factory::registration("warm", pl::make<poly<Base>, Mid2>()));
+		batch.push_back(Factory::registration("new", warm));
+		batch.push_back(Factory::registration::of<Der>());
+		batch.push_back(Factory::registration("new", pl::make<poly<Base>, Der>()));
+		batch.push_back(Factory::registration(typeid(Mid1).name(), warm));
+
+		Factory f1;
+		Factory f2;
+		for (Factory* f : {&f1, &f2}) {
+			f->insert<Mid1>();
+			f->insert_prototype("warm", warm);
+		}
+
+		std::vector<Factory::handle> ids1;
+		f1.bulk_insert(std::make_move_iterator(batch.begin()), std::make_move_iterator(batch.end()),
+			std::back_inserter(ids1));
+
+		// The same types, inserted one by one
+		std::vector<Factory::handle> ids2;
+		ids2.push_back(f2.insert<Der>());
+		ids2.push_back(f2.insert<Mid1>());
+		ids2.push_back(f2.insert_prototype("warm", pl::make<poly<Base>, Mid2>()));
+		ids2.push_back(f2.insert_prototype("new", warm));
+		ids2.push_back(f2.insert<Der>());
+		ids2.push_back(f2.insert_prototype("new", pl::make<poly<Base>, Der>()));
+		ids2.push_back(f2.insert_prototype(typeid(Mid1).name(), warm));
+
+		TEST(ids1 == ids2 && ids1 == std::vector<Factory::handle>({2, 0, 1, 3, 2, 3, 0}));
+		auto names = f1.list();
+		TEST(names == f2.list() && std::is_sorted(names.begin(), names.end()));
+		TEST(f1.make("new").is<Der>() && f1.make("warm").is<Mid2>());
+		TEST(f1.make(typeid(Mid1).name())->name() == "warm mid1" && f1.make(typeid(Der).name()).is<Der>());
+
+		auto ids3 = f1.insert_all<Mid2, Der, Mid2, Base>();
+		TEST(ids3[0] == 4 && ids3[1] == 2 && ids3[2] == 4 && ids3[3] == 5);
+		TEST(f1.make(ids3[0]).is<Mid2>() && f1.make(typeid(Base).name()).is<Base>());
+		TEST(f1.insert_all<>().empty());
+
+		bool thrown = false;
+		try {
+			Factory::registration("empty", poly<Base>());
+		}
+		catch (std::invalid_argument&) {
+			thrown = true;
+		}
+		TEST(thrown);
+	}
+	// recycling policy ======================================================
+	{
+		using Recycled = poly<Base, pl::recycling<Base>>;
+		pl::recycling_statistics before = pl::recycling_stats();
+
+		// Memory of a destroyed object is reused for the next one of its size
+		Recycled p1 = pl::make<Recycled, Der>();
+		void* first = dynamic_cast<void*>(p1.get());
+		p1.reset();
+		Recycled p2 = pl::make<Recycled, Der>();
+		pl::recycling_statistics after = pl::recycling_stats();
+		TEST(dynamic_cast<void*>(p2.get()) == first && p2->name() == "der");
+		TEST(after.hits > before.hits && after.hits + after.misses == before.hits + before.misses + 2);
+
+		Recycled p3 = p2;
+		Recycled p4 = pl::make<Recycled, Large>();
+		TEST(p3.is<Der>() && p3.get() != p2.get() && p4.is<Large>());
+		TEST(pl::recycling_stats().misses > after.misses && pl::recycling_stats().hit_rate() > 0);
+
+		// Objects, destroyed on another thread, come back to this thread's
+		// free list once it runs empty
+		std::vector<Recycled> v;
+		std::vector<void*> freed;
+		for (int i = 0; i < 100; ++i) {
+			v.push_back(pl::make<Recycled, Counted>());
+			freed.push_back(dynamic_cast<void*>(v.back().get()));
+		}
+		before = pl::recycling_stats();
+		std::thread([&] { v.clear(); }).join();
+		TEST(Counted::alive == 0 && pl::recycling_stats().remote_frees == before.remote_frees + 100);
+
+		std::size_t reused = 0;
+		std::size_t slab_blocks = pl::detail::slab_recycler::slab_size / pl::detail::slab_recycler::granularity;
+		for (std::size_t i = 0; i < slab_blocks + freed.size(); ++i) {
+			v.push_back(pl::make<Recycled, Counted>());
+			void* memory = dynamic_cast<void*>(v.back().get());
+			if (std::find(freed.begin(), freed.end(), memory) != freed.end()) ++reused;
+		}
+		TEST(reused == freed.size());
+		v.clear();
+		TEST(Counted::alive == 0);
+	}
+	// iterative policy ======================================================
+	{
+		using Chain = poly<Self_Ptr, pl::iterative<Self_Ptr>>;
+		const std::size_t length = 10000000;
+
+		// Recursive copy and destruction would overflow the stack
+		Chain head;
+		for (std::size_t i = 0; i < length; ++i) {
+			Chain link = pl::make<Chain, Self_Ptr>();
+			link->val = std::move(head);
+			head = std::move(link);
+		}
+		Chain copy = head;
+
+		std::size_t copied = 0;
+		for (const Self_Ptr* link = copy.get(); link; link = link->val.get()) ++copied;
+		TEST(copied == length && copy.get() != head.get() && copy->val.get() != head->val.get());
+		head.reset();
+		copy.reset();
+		TEST(!head && !copy);
+
+		// A failed copy destroys what it has copied so far
+		Chain links;
+		for (int i = 0; i < 10; ++i) {
+			Chain link = i == 5 ? pl::make<Chain, Fragile_Link>() : pl::make<Chain, Counted_Link>();
+			link->val = std::move(links);
+			links = std::move(link);
+		}
+		bool thrown = false;
+		try {
+			Chain failed = links;
+		}
+		catch (std::runtime_error&) {
+			thrown = true;
+		}
+		TEST(thrown && Counted_Link::alive == 9);
+		const Self_Ptr* before_fragile = links.get();
+		while (!before_fragile->val.is<Fragile_Link>()) before_fragile = before_fragile->val.get();
+		Chain tail = before_fragile->val->val;
+		TEST(Counted_Link::alive == 14);
+		links.reset();
+		tail.reset();
+		TEST(Counted_Link::alive == 0);
+
+		// Copies of parents are found through the memo table
+		Tree_Node::ptr tree = make_tree(12, nullptr);
+		Tree_Node::ptr tree_copy = tree;
+		std::size_t nodes = 0;
+		std::size_t copied_nodes = 0;
+		TEST(parents_match(tree.get(), nodes) && parents_match(tree_copy.get(), copied_nodes));
+		TEST(nodes == 4095 && copied_nodes == nodes && tree_copy->left->parent == tree_copy.get());
+		TEST(pl::iterative_clone_of(tree.get()) == nullptr);
+
+		// Children can be moved, copied and dropped by the copy constructor
+		int next_value = 0;
+		Vector_Node::ptr vector_tree = make_vector_tree(3, next_value);
+		Vector_Node::ptr vector_copy = vector_tree;
+		long sum = 0;
+		long copied_sum = 0;
+		TEST(firsts_match(vector_tree.get(), sum) && firsts_match(vector_copy.get(), copied_sum));
+		TEST(sum == 72 * 73 / 2 && copied_sum == sum);
+		TEST(vector_copy->children[3].get() != vector_tree->children[3].get());
+		TEST(!pl::is_trivially_relocatable<Vector_Node::ptr>::value);
+	}
+
+#ifdef POLY_SHARED_MEMORY
+	// shared_arena ==========================================================
+	{
+		using Shared = poly<const Base, pl::shared_memory<const Base>>;
+		pl::shared_arena arena(1 << 20);
+
+		std::vector<Shared> values;
+		for (long i = 0; i < 100; ++i) values.push_back(pl::make<Shared, Shared_Value>(arena, i));
+		TEST(arena.contains(values[0].get()) && !arena.contains(&values));
+		TEST(arena.at<const Base>(arena.offset_of(values[5].get())) == values[5].get());
+
+		// Copies are made in the arena of the original
+		std::size_t live = arena.live();
+		Shared copy = values[7];
+		TEST(arena.contains(copy.get()) && copy.as<const Shared_Value>()->value == 7);
+		copy.reset();
+		TEST(arena.live() == live && arena.used() > live);
+
+		bool full = false;
+		try {
+			arena.allocate(arena.capacity());
+		}
+		catch (std::bad_alloc&) {
+			full = true;
+		}
+		TEST(full);
+
+		// Workers read the objects of the parent, make and destroy their own,
+		// and drop the inherited polys, which leaves the parent's objects alive
+		const int workers = 4;
+		long* sums = static_cast<long*>(arena.allocate(workers * sizeof(long)));
+		std::vector<pid_t> pids;
+		for (int w = 0; w < workers; ++w) {
+			pid_t pid = fork();
+			if (pid == 0) {
+				bool ok = false;
+				try {
+					long sum = 0;
+					for (auto& v : values) sum += v.as<const Shared_Value>()->value;
+					Shared own = pl::make<Shared, Shared_Value>(arena, w);
+					Shared again = values[w];
+					sums[w] = sum + own.as<const Shared_Value>()->value;
+					ok = arena.contains(own.get()) && arena.contains(again.get());
+					values.clear();
+				}
+				catch (...) {
+				}
+				_exit(ok ? 0 : 1);
+			}
+			pids.push_back(pid);
+		}
+
+		bool exited = true;
+		for (pid_t pid : pids) {
+			int status = 0;
+			exited = exited && waitpid(pid, &status, 0) == pid &&
+				WIFEXITED(status) && WEXITSTATUS(status) == 0;
+		}
+		TEST(exited && pids.size() == workers);
+
+		bool summed = true;
+		for (int w = 0; w < workers; ++w) summed = summed && sums[w] == 4950 + w;
+		TEST(summed);
+		TEST(arena.live() == live && values[99].as<const Shared_Value>()->value == 99);
+
+		values.clear();
+		TEST(arena.live() == 0);
 	}
+#endif
 }
 
 #undef TEST
\ No newline at end of file